@@ -0,0 +1,11 @@
+# Profile-guided, link-time optimised release build (GCC or Clang)
+BUILD_DIR=${1:-build-pgo}
+
+# Stage 1: instrumented build, trained by the headless gameplay workload
+cmake -S . -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release -DMINESWEEPER_PGO=GENERATE || exit 1
+cmake --build "$BUILD_DIR" --target pgo_train || exit 1
+
+# Stage 2: rebuild everything from the training profile
+cmake -S . -B "$BUILD_DIR" -DMINESWEEPER_PGO=USE || exit 1
+cmake --build "$BUILD_DIR" || exit 1
+echo "Profile-guided build finished in $BUILD_DIR"
@@ -0,0 +1,280 @@
+#include <atomic>
+#include <functional>
+
+#include "analytics.h"
+#include "generator.h"
+#include "parallel.h"
+#include "replay.h"
+
+namespace {
+    const int CHUNK_GAMES = 4096;   // Manifest lines read and analysed at a time
+
+    // Columns are written in the machine's byte order, little-endian on every target we build
+    template <typename T> void Put(std::ofstream& file, T value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    double Ratio(double numerator, double denominator) {
+        return denominator > 0 ? numerator / denominator : 0.0;
+    }
+
+    int Clicks(const GameStats& game) {
+        return game.reveals + game.flags + game.chords;
+    }
+
+    int ThinkBucket(unsigned int gapMs) {
+        int bucket = 0;
+        while (bucket + 1 < THINK_BUCKETS && gapMs >= (2u << bucket)) {
+            bucket++;
+        }
+        return bucket;
+    }
+
+    // Upper edge in ms of the bucket the given fraction of think times falls in
+    double ThinkPercentile(const int64_t* buckets, double fraction) {
+        int64_t total = 0;
+        for (int bucket = 0; bucket < THINK_BUCKETS; ++bucket) total += buckets[bucket];
+        int64_t seen = 0;
+        for (int bucket = 0; bucket < THINK_BUCKETS; ++bucket) {
+            seen += buckets[bucket];
+            if (total > 0 && seen >= fraction * total) {
+                return (double)(2u << bucket);
+            }
+        }
+        return 0.0;
+    }
+
+    struct GameColumn {
+        const char* name;
+        const char* type;
+        void (*write)(std::ofstream& file, const GameStats& game);
+    };
+
+    const GameColumn GAME_COLUMNS[] = {
+        { "player", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.player); } },
+        { "rows", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.rows); } },
+        { "cols", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.cols); } },
+        { "mines", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.mineCount); } },
+        { "won", "u8", [](std::ofstream& f, const GameStats& g) { Put<uint8_t>(f, g.won); } },
+        { "bbbv", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.bbbv); } },
+        { "clicks", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, Clicks(g)); } },
+        { "reveals", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.reveals); } },
+        { "flags", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.flags); } },
+        { "chords", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.chords); } },
+        { "misflags", "i32", [](std::ofstream& f, const GameStats& g) { Put<int32_t>(f, g.misflags); } },
+        { "time_ms", "u32", [](std::ofstream& f, const GameStats& g) { Put<uint32_t>(f, g.timeMs); } },
+        // Efficiency (3BV per click) and 3BV/s only mean something for cleared boards
+        { "efficiency", "f64", [](std::ofstream& f, const GameStats& g) {
+            Put<double>(f, g.won ? Ratio(g.bbbv, Clicks(g)) : 0.0);
+        } },
+        { "bbbv_per_s", "f64", [](std::ofstream& f, const GameStats& g) {
+            Put<double>(f, g.won ? Ratio(g.bbbv, g.timeMs / 1000.0) : 0.0);
+        } },
+    };
+}
+
+bool ReplayAnalytics::AnalyzeGame(const std::string& replayPath, Board& board, GameStats& stats) {
+    ReplayReader reader;
+    if (!reader.Open(replayPath)) {
+        return false;
+    }
+    const ReplayHeader& header = reader.Header();
+    board.Generate(header.rows, header.cols, header.mineCount, header.seed);
+
+    stats = GameStats();
+    stats.rows = header.rows;
+    stats.cols = header.cols;
+    stats.mineCount = header.mineCount;
+    stats.bbbv = BoardGenerator::Compute3BV(board);
+
+    ReplayMove move;
+    unsigned int lastMs = 0;
+    while (reader.Next(move)) {
+        if (!board.IsValidCell(move.row, move.col)) {
+            return false;
+        }
+        stats.thinkTimes[ThinkBucket(move.timeMs - lastMs)]++;
+        lastMs = move.timeMs;
+        stats.timeMs = move.timeMs;
+
+        RevealOutcome outcome = RevealOutcome::NONE;
+        switch (move.type) {
+            case MoveType::REVEAL:
+                stats.reveals++;
+                outcome = board.RevealCell(move.row, move.col);
+                break;
+            case MoveType::FLAG:
+                if (board.At(move.row, move.col).state == CellState::HIDDEN) {
+                    stats.flags++;
+                    stats.misflags += !board.At(move.row, move.col).hasMine;
+                }
+                board.ToggleFlag(move.row, move.col);
+                break;
+            case MoveType::CHORD:
+                stats.chords++;
+                outcome = board.RevealAdjacentCells(move.row, move.col);
+                break;
+            default:
+                return false;
+        }
+        if (outcome == RevealOutcome::WON || outcome == RevealOutcome::HIT_MINE) {
+            stats.won = outcome == RevealOutcome::WON;
+            break;
+        }
+    }
+    return !reader.Truncated();  // A partial game would skew every average it lands in
+}
+
+int ReplayAnalytics::PlayerIndex(const std::string& name) {
+    auto found = playerIndex.find(name);
+    if (found != playerIndex.end()) {
+        return found->second;
+    }
+    int index = (int)players.size();
+    playerIndex[name] = index;
+    players.push_back(name);
+    totals.push_back(PlayerStats());
+    return index;
+}
+
+bool ReplayAnalytics::Run(const std::string& manifestPath, const std::string& outputDir) {
+    players.clear();
+    playerIndex.clear();
+    totals.clear();
+    schema.clear();
+    gameColumns.clear();
+    gameCount = 0;
+    skippedCount = 0;
+
+    std::ifstream manifest(manifestPath);
+    if (!manifest.is_open()) {
+        return false;
+    }
+    for (const GameColumn& column : GAME_COLUMNS) {
+        gameColumns.emplace_back(outputDir + "/games." + column.name, std::ios::binary);
+        if (!gameColumns.back().is_open()) {
+            return false;
+        }
+        schema.push_back(std::string("games.") + column.name + " " + column.type);
+    }
+
+    // One board per worker, reused for every game that worker replays
+    int workerCount = WorkerCount();
+    std::vector<Board> boards(workerCount);
+    std::vector<std::string> paths;
+    std::vector<int> playerOf;
+    std::vector<GameStats> games(CHUNK_GAMES);
+    std::vector<char> valid(CHUNK_GAMES);
+    std::string line;
+    bool more = true;
+    while (more) {
+        paths.clear();
+        playerOf.clear();
+        while ((int)paths.size() < CHUNK_GAMES && (more = (bool)std::getline(manifest, line))) {
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            size_t tab = line.find('\t');
+            if (tab == std::string::npos) {
+                skippedCount += !line.empty();
+                continue;
+            }
+            playerOf.push_back(PlayerIndex(line.substr(0, tab)));
+            paths.push_back(line.substr(tab + 1));
+        }
+
+        int count = (int)paths.size();
+        std::atomic<int> next(0);
+        ParallelFor(workerCount, [&](int worker) {
+            for (int i = next++; i < count; i = next++) {
+                valid[i] = AnalyzeGame(paths[i], boards[worker], games[i]);
+                games[i].player = playerOf[i];
+            }
+        });
+
+        for (int i = 0; i < count; ++i) {
+            if (!valid[i]) {
+                skippedCount++;
+                continue;
+            }
+            const GameStats& game = games[i];
+            PlayerStats& player = totals[game.player];
+            player.games++;
+            player.clicks += Clicks(game);
+            player.chords += game.chords;
+            player.flags += game.flags;
+            player.misflags += game.misflags;
+            if (game.won) {
+                player.wins++;
+                player.wonBbbv += game.bbbv;
+                player.wonClicks += Clicks(game);
+                player.wonTimeMs += game.timeMs;
+            }
+            for (int bucket = 0; bucket < THINK_BUCKETS; ++bucket) {
+                player.thinkTimes[bucket] += game.thinkTimes[bucket];
+            }
+            for (size_t column = 0; column < gameColumns.size(); ++column) {
+                GAME_COLUMNS[column].write(gameColumns[column], game);
+            }
+            gameCount++;
+        }
+    }
+
+    for (std::ofstream& column : gameColumns) {
+        column.close();
+        if (column.fail()) {
+            return false;
+        }
+    }
+    gameColumns.clear();
+    return WritePlayers(outputDir);
+}
+
+bool ReplayAnalytics::WritePlayers(const std::string& outputDir) {
+    std::ofstream names(outputDir + "/players.name");
+    for (const std::string& name : players) {
+        names << name << '\n';
+    }
+    schema.push_back("players.name text");
+
+    // Each column is a function of a player's totals
+    struct PlayerColumn {
+        std::string name;
+        bool isInteger;
+        std::function<double(const PlayerStats&)> value;
+    };
+    std::vector<PlayerColumn> columns = {
+        { "games", true, [](const PlayerStats& p) { return (double)p.games; } },
+        { "wins", true, [](const PlayerStats& p) { return (double)p.wins; } },
+        { "clicks", true, [](const PlayerStats& p) { return (double)p.clicks; } },
+        { "chords", true, [](const PlayerStats& p) { return (double)p.chords; } },
+        { "flags", true, [](const PlayerStats& p) { return (double)p.flags; } },
+        { "misflags", true, [](const PlayerStats& p) { return (double)p.misflags; } },
+        { "efficiency", false, [](const PlayerStats& p) { return Ratio(p.wonBbbv, p.wonClicks); } },
+        { "bbbv_per_s", false, [](const PlayerStats& p) { return Ratio(p.wonBbbv, p.wonTimeMs / 1000.0); } },
+        { "misflag_rate", false, [](const PlayerStats& p) { return Ratio(p.misflags, p.flags); } },
+        { "chord_rate", false, [](const PlayerStats& p) { return Ratio(p.chords, p.clicks); } },
+        { "think_p50_ms", false, [](const PlayerStats& p) { return ThinkPercentile(p.thinkTimes, 0.5); } },
+        { "think_p90_ms", false, [](const PlayerStats& p) { return ThinkPercentile(p.thinkTimes, 0.9); } },
+    };
+    for (int bucket = 0; bucket < THINK_BUCKETS; ++bucket) {
+        std::string name = "think_under_" + std::to_string(2u << bucket) + "ms";
+        if (bucket + 1 == THINK_BUCKETS) name = "think_over_" + std::to_string(1u << bucket) + "ms";
+        columns.push_back({ name, true, [bucket](const PlayerStats& p) { return (double)p.thinkTimes[bucket]; } });
+    }
+
+    bool ok = names.good();
+    for (const PlayerColumn& column : columns) {
+        std::ofstream file(outputDir + "/players." + column.name, std::ios::binary);
+        for (const PlayerStats& player : totals) {
+            if (column.isInteger) Put<int64_t>(file, (int64_t)column.value(player));
+            else Put<double>(file, column.value(player));
+        }
+        ok = ok && file.good();
+        schema.push_back("players." + column.name + (column.isInteger ? " i64" : " f64"));
+    }
+
+    std::ofstream schemaFile(outputDir + "/schema.txt");
+    for (const std::string& entry : schema) {
+        schemaFile << entry << '\n';
+    }
+    return ok && schemaFile.good();
+}
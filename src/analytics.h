@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "board.h"
+
+// Think times (gaps between moves) are bucketed by powers of two: bucket b holds gaps
+// below 2^(b+1) ms that don't fit an earlier bucket, and the last bucket is open-ended
+const int THINK_BUCKETS = 16;
+
+// Figures for one recorded game
+struct GameStats {
+    int player;              // Index into ReplayAnalytics::Players()
+    int rows;
+    int cols;
+    int mineCount;
+    bool won;
+    int bbbv;
+    int reveals;
+    int flags;               // Flags placed (removing a flag isn't counted)
+    int chords;
+    int misflags;            // Flags placed on safe cells
+    unsigned int timeMs;     // Time of the last move
+    int thinkTimes[THINK_BUCKETS];
+};
+
+// Totals for one player over every game in the corpus
+struct PlayerStats {
+    int64_t games;
+    int64_t wins;
+    int64_t clicks;
+    int64_t chords;
+    int64_t flags;
+    int64_t misflags;
+    int64_t wonBbbv;         // 3BV and clicks of won games, for efficiency
+    int64_t wonClicks;
+    int64_t wonTimeMs;
+    int64_t thinkTimes[THINK_BUCKETS];
+};
+
+// Streams a corpus of replays and writes per-game and per-player statistics as columns.
+// The manifest has one "player<TAB>replay path" line per game. Games are read in chunks;
+// each chunk is split between worker threads, and every worker replays one game at a time
+// on its own board, so memory stays constant however large the corpus is. Output goes to
+// an existing directory as one little-endian binary file per column ("games.bbbv",
+// "players.efficiency", ...), plus "players.name" as text lines and "schema.txt" listing
+// every column with its type.
+class ReplayAnalytics
+{
+public:
+    ReplayAnalytics() : gameCount(0), skippedCount(0) {}
+
+    // Returns false if the manifest or an output file can't be opened
+    bool Run(const std::string& manifestPath, const std::string& outputDir);
+
+    // Replays one game; false if the file isn't a valid replay
+    static bool AnalyzeGame(const std::string& replayPath, Board& board, GameStats& stats);
+
+    const std::vector<std::string>& Players() const { return players; }
+    const std::vector<PlayerStats>& Totals() const { return totals; }
+    int64_t GameCount() const { return gameCount; }
+    int64_t SkippedCount() const { return skippedCount; }
+
+private:
+    int PlayerIndex(const std::string& name);
+    bool WritePlayers(const std::string& outputDir);
+
+    std::vector<std::string> players;
+    std::unordered_map<std::string, int> playerIndex;
+    std::vector<PlayerStats> totals;
+    std::vector<std::ofstream> gameColumns;
+    std::vector<std::string> schema;
+    int64_t gameCount;
+    int64_t skippedCount;
+};
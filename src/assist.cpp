@@ -0,0 +1,87 @@
+#include "assist.h"
+
+void AutoAssist::Push(const Board& board, int index) {
+    // Only numbers with hidden cells around them can lead to a move
+    const Cell& cell = board.AtIndex(index);
+    if (queued[index] || cell.state != CellState::REVEALED || cell.hasMine ||
+        cell.adjacentMines == 0 || cell.hiddenNeighbors == 0) {
+        return;
+    }
+    queued[index] = 1;
+    worklist.push_back(index);
+}
+
+void AutoAssist::PushAround(const Board& board, int index) {
+    int row = index / board.Cols();
+    int col = index % board.Cols();
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if (board.IsValidCell(row + dr, col + dc)) {
+                Push(board, board.Index(row + dr, col + dc));
+            }
+        }
+    }
+}
+
+RevealOutcome AutoAssist::Run(Board& board, const std::vector<int>& changedCells, std::vector<AssistMove>& moves) {
+    moves.clear();
+    worklist.clear();
+    if ((int)queued.size() != board.Rows() * board.Cols()) {
+        queued.assign(board.Rows() * board.Cols(), 0);
+    }
+    for (int index : changedCells) {
+        PushAround(board, index);
+    }
+
+    RevealOutcome result = RevealOutcome::NONE;
+    while (!worklist.empty()) {
+        int index = worklist.back();
+        worklist.pop_back();
+        queued[index] = 0;
+
+        const Cell& cell = board.AtIndex(index);
+        if (cell.hiddenNeighbors == 0) {
+            continue;  // Settled since it was queued
+        }
+        int row = index / board.Cols();
+        int col = index % board.Cols();
+        int minesLeft = cell.adjacentMines - cell.flaggedNeighbors;
+
+        if (minesLeft == cell.hiddenNeighbors) {
+            // Every hidden neighbour is a mine
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    int newRow = row + dr;
+                    int newCol = col + dc;
+                    if (!board.IsValidCell(newRow, newCol) ||
+                        board.At(newRow, newCol).state != CellState::HIDDEN) continue;
+                    board.ToggleFlag(newRow, newCol);
+                    moves.push_back({ MoveType::FLAG, newRow, newCol });
+                    PushAround(board, board.Index(newRow, newCol));
+                }
+            }
+        } else if (minesLeft == 0) {
+            // All mines are flagged, so the rest is safe (as far as the player's flags are right)
+            changed.clear();
+            RevealOutcome outcome = board.RevealAdjacentCells(row, col, &changed);
+            if (outcome == RevealOutcome::NONE) {
+                continue;
+            }
+            moves.push_back({ MoveType::CHORD, row, col });
+            result = outcome;
+            if (outcome != RevealOutcome::REVEALED) {
+                break;  // Hit a mine or won
+            }
+            for (int changedIndex : changed) {
+                PushAround(board, changedIndex);
+            }
+        }
+    }
+
+    // Leave the marks clear for next time without sweeping the whole board
+    for (int index : worklist) {
+        queued[index] = 0;
+    }
+    worklist.clear();
+    return result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+#include "board.h"
+#include "replay.h"
+
+// A move the assist made on the player's behalf
+struct AssistMove {
+    MoveType type;  // FLAG or CHORD
+    int row;
+    int col;
+};
+
+// Resolves the trivial consequences of a move: numbers whose hidden neighbours must all be
+// mines get flagged, and numbers with all their flags placed get chorded. Only the cells a
+// move changed (and the numbers around them) are examined, and every change feeds the
+// worklist again until nothing is left to do.
+class AutoAssist
+{
+public:
+    // Returns the outcome of the assist's own moves (NONE if it did nothing)
+    RevealOutcome Run(Board& board, const std::vector<int>& changedCells, std::vector<AssistMove>& moves);
+
+private:
+    void Push(const Board& board, int index);
+    void PushAround(const Board& board, int index);
+
+    std::vector<int> worklist;
+    std::vector<char> queued;   // Cells currently in the worklist
+    std::vector<int> changed;   // Cells changed by the assist's last chord
+};
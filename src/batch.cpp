@@ -0,0 +1,96 @@
+#include <algorithm>
+
+#include "batch.h"
+#include "board.h"
+
+const int BoardBatch::LANES;
+
+void BoardBatch::Generate(int rows, int cols, int mineCount, const std::vector<unsigned int>& seeds) {
+    this->rows = rows;
+    this->cols = cols;
+    this->seeds.assign(seeds.begin(), seeds.begin() + std::min((int)seeds.size(), LANES));
+    int cellCount = rows * cols;
+    mines.assign(cellCount, 0);
+    this->mineCount = mineCount;
+    for (int lane = 0; lane < Lanes(); ++lane) {
+        uint64_t bit = 1ULL << lane;
+        this->mineCount = Board::PlaceMines(rows, cols, mineCount, this->seeds[lane],
+                                            [&](int index) { mines[index] |= bit; });
+    }
+
+    // Mines in each cell and its left and right neighbours, as a 2-bit number per lane
+    std::vector<uint64_t> across0(cellCount);
+    std::vector<uint64_t> across1(cellCount);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int index = row * cols + col;
+            uint64_t left = col > 0 ? mines[index - 1] : 0;
+            uint64_t right = col + 1 < cols ? mines[index + 1] : 0;
+            uint64_t center = mines[index];
+            across0[index] = left ^ center ^ right;
+            across1[index] = (left & center) | (right & (left ^ center));
+        }
+    }
+
+    // Neighbours = row above (3 cells) + row below (3 cells) + left + right, added with
+    // ripple-carry adders across the lanes; the total never exceeds 8, so 4 bits hold it
+    for (std::vector<uint64_t>& plane : counts) {
+        plane.assign(cellCount, 0);
+    }
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            int index = row * cols + col;
+            uint64_t above0 = row > 0 ? across0[index - cols] : 0;
+            uint64_t above1 = row > 0 ? across1[index - cols] : 0;
+            uint64_t below0 = row + 1 < rows ? across0[index + cols] : 0;
+            uint64_t below1 = row + 1 < rows ? across1[index + cols] : 0;
+            uint64_t left = col > 0 ? mines[index - 1] : 0;
+            uint64_t right = col + 1 < cols ? mines[index + 1] : 0;
+            uint64_t side0 = left ^ right;
+            uint64_t side1 = left & right;
+
+            // above + below: 3 bits
+            uint64_t sum0 = above0 ^ below0;
+            uint64_t carry = above0 & below0;
+            uint64_t sum1 = above1 ^ below1 ^ carry;
+            uint64_t sum2 = (above1 & below1) | (carry & (above1 ^ below1));
+
+            // + side: 4 bits
+            uint64_t total0 = sum0 ^ side0;
+            carry = sum0 & side0;
+            uint64_t total1 = sum1 ^ side1 ^ carry;
+            carry = (sum1 & side1) | (carry & (sum1 ^ side1));
+            counts[0][index] = total0;
+            counts[1][index] = total1;
+            counts[2][index] = sum2 ^ carry;
+            counts[3][index] = sum2 & carry;
+        }
+    }
+}
+
+uint64_t BoardBatch::Zeros(int index) const {
+    uint64_t lanes = Lanes() == LANES ? ~0ULL : (1ULL << Lanes()) - 1;
+    return lanes & ~mines[index] & ~(counts[0][index] | counts[1][index] | counts[2][index] | counts[3][index]);
+}
+
+int BoardBatch::AdjacentMines(int lane, int row, int col) const {
+    int index = row * cols + col;
+    if ((mines[index] >> lane) & 1) {
+        return 0;
+    }
+    int count = 0;
+    for (int bit = 0; bit < 4; ++bit) {
+        count |= (int)((counts[bit][index] >> lane) & 1) << bit;
+    }
+    return count;
+}
+
+void BoardBatch::Extract(int lane, Board& board) const {
+    board.Reset(rows, cols);
+    board.ForEachCell([&](int row, int col, Cell& cell) {
+        cell.hasMine = HasMine(lane, row, col);
+        cell.adjacentMines = (uint8_t)AdjacentMines(lane, row, col);
+    });
+    board.RebuildIndexes();
+    board.SetRemainingCells(rows * cols - mineCount);
+}
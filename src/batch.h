@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Board;
+
+// Up to 64 boards of one size and mine count generated together, one board per bit lane:
+// bit b of a cell's word belongs to board b. Each lane's mines are exactly the ones
+// Board::Generate would lay for its seed, and the adjacency counts of all lanes are added
+// at once by a bit-sliced adder, so small boards cost a few word operations per cell for
+// the whole batch instead of a full Generate each.
+class BoardBatch
+{
+public:
+    static const int LANES = 64;
+
+    // At most LANES seeds; lane b is the board for seeds[b]
+    void Generate(int rows, int cols, int mineCount, const std::vector<unsigned int>& seeds);
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    int Lanes() const { return (int)seeds.size(); }
+    int MineCount() const { return mineCount; }  // After clamping, as Board::Generate does
+    unsigned int Seed(int lane) const { return seeds[lane]; }
+
+    // Lane masks for the cell at a row-major index
+    uint64_t Mines(int index) const { return mines[index]; }
+    uint64_t Zeros(int index) const;  // Safe cells with no adjacent mines (opening cells)
+
+    bool HasMine(int lane, int row, int col) const { return (mines[row * cols + col] >> lane) & 1; }
+    int AdjacentMines(int lane, int row, int col) const;  // 0 on mines, as on a Board
+    void Extract(int lane, Board& board) const;           // Same board as Generate with the lane's seed
+
+private:
+    int rows;
+    int cols;
+    int mineCount;
+    std::vector<unsigned int> seeds;
+    std::vector<uint64_t> mines;
+    std::vector<uint64_t> counts[4];  // Adjacent mine count per cell, bit i of every lane in counts[i]
+};
@@ -0,0 +1,735 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+
+#include "board.h"
+#include "parallel.h"
+
+namespace {
+    const uint64_t SPLIT_STREAM = ~0ULL;  // Stream used to split the mines between stripes
+    const int PARALLEL_CASCADE_MIN = 8192;  // Cascade frontier worth sharing between threads
+    const int PARALLEL_REVEAL_MIN = 32768;  // Batch of reveals worth sharing between threads
+    const int CHUNK_CELLS = 2048;           // Cells per parallel task
+    const int TILE_SIZE = 8;                // Tiled layout: 8x8 cells per tile
+    const int MAX_MORTON_TILES = 64;        // Morton order within blocks of up to 64x64 tiles
+
+    // Generations are unique across every board in the process, not just per object, so a
+    // cache keyed on one (a solver's encoding) can't mistake another board for the one it saw
+    std::atomic<unsigned int> lastGeneration(0);
+    unsigned int NextGeneration() {
+        return ++lastGeneration;
+    }
+
+    // Spreads the bits of x apart so two spread values interleave into a Morton code
+    int SpreadBits(int x) {
+        int spread = 0;
+        for (int bit = 0; (x >> bit) != 0; ++bit) {
+            spread |= ((x >> bit) & 1) << (2 * bit);
+        }
+        return spread;
+    }
+
+    uint64_t Mix(uint64_t x) {
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // Counter-based generator: output i of stream s is a pure function of (seed, s, i), so
+    // any stream can be drawn from anywhere without the others
+    class StreamRng
+    {
+    public:
+        StreamRng(unsigned int seed, uint64_t stream)
+            : key(Mix(((uint64_t)seed << 32 | 0x5EED) ^ Mix(stream + 1))), counter(0) {}
+
+        uint64_t Next() { return Mix(key + 0x9E3779B97F4A7C15ULL * ++counter); }
+        double Uniform() { return (Next() >> 11) * (1.0 / 9007199254740992.0); }
+
+        // Uniform in [0, range), without modulo bias
+        uint64_t Below(uint64_t range) {
+            uint64_t limit = ~0ULL - ~0ULL % range;
+            uint64_t value = Next();
+            while (value >= limit) value = Next();
+            return value % range;
+        }
+
+    private:
+        uint64_t key;
+        uint64_t counter;
+    };
+
+    double LogChoose(int64_t n, int64_t k) {
+        return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+    }
+
+    // Successes in "draws" draws without replacement from "population" items of which
+    // "successes" are successes. Inversion outward from the mode: O(standard deviation) steps.
+    int64_t SampleHypergeometric(StreamRng& rng, int64_t population, int64_t successes, int64_t draws) {
+        int64_t low = std::max<int64_t>(0, draws - (population - successes));
+        int64_t high = std::min(draws, successes);
+        if (low == high) {
+            return low;
+        }
+        int64_t mode = (draws + 1) * (successes + 1) / (population + 2);
+        mode = std::max(low, std::min(high, mode));
+        double modeP = std::exp(LogChoose(successes, mode) + LogChoose(population - successes, draws - mode) -
+                                LogChoose(population, draws));
+
+        double u = rng.Uniform() - modeP;
+        int64_t up = mode;
+        int64_t down = mode;
+        double upP = modeP;
+        double downP = modeP;
+        while (u >= 0.0) {
+            if (up < high) {
+                // P(x + 1) / P(x)
+                upP *= (double)(successes - up) * (draws - up) /
+                       ((double)(up + 1) * (population - successes - draws + up + 1));
+                up++;
+                u -= upP;
+                if (u < 0.0) return up;
+            }
+            if (down > low) {
+                downP *= (double)down * (population - successes - draws + down) /
+                         ((double)(successes - down + 1) * (draws - down + 1));
+                down--;
+                u -= downP;
+                if (u < 0.0) return down;
+            }
+            if (up >= high && down <= low) {
+                break;  // Rounding left a sliver of probability unassigned
+            }
+        }
+        return mode;
+    }
+}
+
+Board::Board()
+    : rows(0), cols(0), layout(CellLayout::ROW_MAJOR), remainingCells(0), flagCount(0), version(0), generation(0),
+      summaryVersion(~0u)
+{
+}
+
+void Board::Reset(int rows, int cols) {
+    this->rows = rows;
+    this->cols = cols;
+    BuildLayout();
+    remainingCells = rows * cols;
+    revealClaims.Resize(rows * cols);
+    recountMarks.Resize(rows * cols);
+    openings.Clear();
+    version++;
+    generation = NextGeneration();
+}
+
+void Board::BuildLayout() {
+    rowSlot.resize(rows);
+    colSlot.resize(cols);
+    int slotCount = rows * cols;
+    if (layout == CellLayout::ROW_MAJOR) {
+        for (int row = 0; row < rows; ++row) rowSlot[row] = row * cols;
+        for (int col = 0; col < cols; ++col) colSlot[col] = col;
+    } else {
+        // Tiles are Morton-ordered within square blocks of blockTiles x blockTiles tiles, and
+        // the blocks are row-major. The block is kept no larger than the shorter side of the
+        // board so long thin boards don't pad out to a square. A Morton code is the sum of a
+        // row part and a column part, so slots still split into rowSlot + colSlot.
+        int tileRows = (rows + TILE_SIZE - 1) / TILE_SIZE;
+        int tileCols = (cols + TILE_SIZE - 1) / TILE_SIZE;
+        int blockTiles = 1;
+        while (blockTiles * 2 <= std::min(tileRows, tileCols) && blockTiles * 2 <= MAX_MORTON_TILES) {
+            blockTiles *= 2;
+        }
+        int blockCols = (tileCols + blockTiles - 1) / blockTiles;
+        int blockRows = (tileRows + blockTiles - 1) / blockTiles;
+        int tileCells = TILE_SIZE * TILE_SIZE;
+        int blockCells = blockTiles * blockTiles * tileCells;
+        for (int row = 0; row < rows; ++row) {
+            int tile = row / TILE_SIZE;
+            rowSlot[row] = (tile / blockTiles) * blockCols * blockCells +
+                           (SpreadBits(tile % blockTiles) << 1) * tileCells + (row % TILE_SIZE) * TILE_SIZE;
+        }
+        for (int col = 0; col < cols; ++col) {
+            int tile = col / TILE_SIZE;
+            colSlot[col] = (tile / blockTiles) * blockCells +
+                           SpreadBits(tile % blockTiles) * tileCells + col % TILE_SIZE;
+        }
+        slotCount = blockRows * blockCols * blockCells;
+    }
+    cells.assign(slotCount, { false, CellState::HIDDEN, 0, 0, 0, 0 });
+}
+
+std::vector<int> Board::CornerCells(int rows, int cols) {
+    std::vector<int> corners = { 0, cols - 1, (rows - 1) * cols, rows * cols - 1 };
+    std::sort(corners.begin(), corners.end());
+    corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+    return corners;
+}
+
+void Board::Generate(int rows, int cols, int mineCount, unsigned int seed) {
+    Reset(rows, cols);
+    mineCount = PlaceMines(rows, cols, mineCount, seed, [this](int index) { CellAt(index).hasMine = true; });
+    CalculateAdjacentMines();
+    RebuildIndexes();
+    remainingCells = rows * cols - mineCount;
+}
+
+int Board::DefaultMineCount(int rows, int cols) {
+    // Approximately 15% of cells, a good balance between challenge and playability
+    return std::max(1, static_cast<int>(rows * cols * 0.15f));
+}
+
+int Board::PlaceMines(int rows, int cols, int mineCount, unsigned int seed, const std::function<void(int)>& place) {
+    int stripeCount = StripeCount(rows);
+    std::vector<int> corners = CornerCells(rows, cols);
+
+    // Corners are always safe; every other cell is eligible for a mine
+    std::vector<int64_t> eligible(stripeCount);
+    int64_t eligibleTotal = 0;
+    for (int stripe = 0; stripe < stripeCount; ++stripe) {
+        int begin = stripe * STRIPE_ROWS * cols;
+        int end = std::min(rows, (stripe + 1) * STRIPE_ROWS) * cols;
+        eligible[stripe] = end - begin;
+        for (int corner : corners) {
+            if (corner >= begin && corner < end) eligible[stripe]--;
+        }
+        eligibleTotal += eligible[stripe];
+    }
+    if (mineCount > eligibleTotal) {
+        mineCount = (int)eligibleTotal;
+    }
+
+    // Split the mines between stripes exactly as a uniform draw over the whole board would:
+    // each stripe's share is hypergeometric given what the stripes before it took
+    std::vector<int> stripeMines(stripeCount);
+    StreamRng splitRng(seed, SPLIT_STREAM);
+    int64_t cellsLeft = eligibleTotal;
+    int minesLeft = mineCount;
+    for (int stripe = 0; stripe < stripeCount; ++stripe) {
+        stripeMines[stripe] = (int)SampleHypergeometric(splitRng, cellsLeft, eligible[stripe], minesLeft);
+        cellsLeft -= eligible[stripe];
+        minesLeft -= stripeMines[stripe];
+    }
+
+    // Each stripe places its mines from its own stream, so the board depends only on the
+    // seed and never on how many threads ran or in which order
+    ParallelFor(stripeCount, [&](int stripe) {
+        int begin = stripe * STRIPE_ROWS * cols;
+        int count = (int)eligible[stripe];
+        StreamRng rng(seed, stripe);
+        std::vector<char> chosen(count, 0);
+
+        // Floyd's sampling: exactly stripeMines distinct positions, one draw each
+        for (int j = count - stripeMines[stripe]; j < count; ++j) {
+            int t = (int)rng.Below((uint64_t)j + 1);
+            chosen[chosen[t] ? j : t] = 1;
+        }
+        int index = begin;
+        size_t corner = 0;
+        for (int k = 0; k < count; ++k, ++index) {
+            while (corner < corners.size() && corners[corner] < index) corner++;
+            while (corner < corners.size() && corners[corner] == index) {
+                index++;
+                corner++;
+            }
+            if (chosen[k]) place(index);
+        }
+    });
+    return mineCount;
+}
+
+void Board::CalculateAdjacentMines() {
+    // Stripes read one halo row above and below; mines are only read, so stripes can't race
+    int stripeCount = StripeCount(rows);
+    ParallelFor(stripeCount, [&](int stripe) {
+        int rowEnd = std::min(rows, (stripe + 1) * STRIPE_ROWS);
+        std::vector<int> columnSums(cols + 2, 0);  // Mines in rows row-1..row+1 of each column, padded
+        for (int row = stripe * STRIPE_ROWS; row < rowEnd; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                int sum = 0;
+                for (int r = row - 1; r <= row + 1; ++r) {
+                    if (r >= 0 && r < rows && At(r, col).hasMine) sum++;
+                }
+                columnSums[col + 1] = sum;
+            }
+            for (int col = 0; col < cols; ++col) {
+                Cell& cell = At(row, col);
+                if (!cell.hasMine) {
+                    cell.adjacentMines = columnSums[col] + columnSums[col + 1] + columnSums[col + 2];
+                }
+            }
+        }
+    });
+}
+
+void Board::CalculateNeighborCounts() {
+    int stripeCount = StripeCount(rows);
+    std::vector<int> stripeFlags(stripeCount, 0);
+    ParallelFor(stripeCount, [&](int stripe) {
+        int rowEnd = std::min(rows, (stripe + 1) * STRIPE_ROWS);
+        ForEachCellIn(stripe * STRIPE_ROWS, rowEnd, 0, cols, [&](int row, int col, Cell& cell) {
+            cell.flaggedNeighbors = 0;
+            cell.hiddenNeighbors = 0;
+            cell.misflaggedNeighbors = 0;
+            if (cell.state == CellState::FLAGGED) {
+                stripeFlags[stripe]++;
+            }
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if ((dr == 0 && dc == 0) || !IsValidCell(row + dr, col + dc)) continue;
+                    const Cell& neighbor = At(row + dr, col + dc);
+                    if (neighbor.state == CellState::HIDDEN) {
+                        cell.hiddenNeighbors++;
+                    } else if (neighbor.state == CellState::FLAGGED) {
+                        cell.flaggedNeighbors++;
+                        if (!neighbor.hasMine) {
+                            cell.misflaggedNeighbors++;
+                        }
+                    }
+                }
+            }
+        });
+    });
+    flagCount = 0;
+    for (int flags : stripeFlags) {
+        flagCount += flags;
+    }
+}
+
+void Board::SetState(int index, CellState state) {
+    int row = index / cols;
+    int col = index % cols;
+    Cell& cell = At(row, col);
+    CellState oldState = cell.state;
+    if (oldState == state) {
+        return;
+    }
+    cell.state = state;
+
+    int hiddenDelta = (state == CellState::HIDDEN) - (oldState == CellState::HIDDEN);
+    int flaggedDelta = (state == CellState::FLAGGED) - (oldState == CellState::FLAGGED);
+    int misflaggedDelta = cell.hasMine ? 0 : flaggedDelta;
+    flagCount += flaggedDelta;
+
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if ((dr == 0 && dc == 0) || !IsValidCell(row + dr, col + dc)) continue;
+            Cell& neighbor = At(row + dr, col + dc);
+            neighbor.hiddenNeighbors += hiddenDelta;
+            neighbor.flaggedNeighbors += flaggedDelta;
+            neighbor.misflaggedNeighbors += misflaggedDelta;
+        }
+    }
+}
+
+bool Board::IsSatisfied(int row, int col) const {
+    const Cell& cell = At(row, col);
+    return cell.state == CellState::REVEALED && !cell.hasMine && cell.adjacentMines > 0 &&
+           cell.flaggedNeighbors == cell.adjacentMines;
+}
+
+void Board::RebuildIndexes() {
+    CalculateNeighborCounts();
+    openings.Build(*this);
+    frontier.Rebuild(*this);
+    version++;
+    generation = NextGeneration();
+}
+
+const BoardSummary& Board::Summary() const {
+    if (summaryVersion != version) {
+        summary.Build(*this);
+        summaryVersion = version;
+    }
+    return summary;
+}
+
+void Board::BeginChange() {
+    touched.clear();
+}
+
+void Board::EndChange(std::vector<int>* changed) {
+    // Only the touched cells and their neighbours can enter or leave the frontier
+    frontier.Update(*this, touched);
+    if (changed) {
+        changed->insert(changed->end(), touched.begin(), touched.end());
+    }
+}
+
+bool Board::IsValidCell(int row, int col) const {
+    return row >= 0 && row < rows && col >= 0 && col < cols;
+}
+
+RevealOutcome Board::RevealCell(int row, int col, std::vector<int>* changed) {
+    BeginChange();
+    RevealOutcome outcome = RevealCellImpl(row, col);
+    EndChange(changed);
+    return outcome;
+}
+
+RevealOutcome Board::RevealCellImpl(int row, int col) {
+    if (!IsValidCell(row, col) || At(row, col).state != CellState::HIDDEN) {
+        return RevealOutcome::NONE;
+    }
+
+    version++;
+    Cell& cell = At(row, col);
+    if (cell.hasMine) {
+        SetState(Index(row, col), CellState::REVEALED);
+        touched.push_back(Index(row, col));
+        return RevealOutcome::HIT_MINE;
+    }
+
+    // An untouched opening reveals exactly its precomputed spans; anything else (a number,
+    // or an opening a flag or earlier reveal has cut into) needs the cascade
+    int opening = openings.OpeningOf(Index(row, col));
+    if (opening >= 0 && openings.IsUntouched(opening)) {
+        RevealOpening(opening);
+    } else {
+        RevealCascade(row, col);
+    }
+    return remainingCells == 0 ? RevealOutcome::WON : RevealOutcome::REVEALED;
+}
+
+void Board::RevealOpening(int opening) {
+    revealBatch.clear();
+    for (const CellSpan* span = openings.SpansBegin(opening); span != openings.SpansEnd(opening); ++span) {
+        int index = Index(span->row, span->colBegin);
+        for (int col = span->colBegin; col < span->colEnd; ++col, ++index) {
+            if (At(span->row, col).state == CellState::HIDDEN) {
+                revealBatch.push_back(index);
+            }
+        }
+    }
+    RevealBatch(revealBatch);
+    openings.MarkFullyRevealed(opening);
+}
+
+void Board::RevealCascade(int row, int col) {
+    // Same result as revealing recursively, without the recursion depth on big openings
+    cascadeStack.clear();
+    SetState(Index(row, col), CellState::REVEALED);
+    cascadeStack.push_back(Index(row, col));
+
+    while (!cascadeStack.empty()) {
+        if ((int)cascadeStack.size() >= PARALLEL_CASCADE_MIN && WorkerCount() > 1) {
+            RevealCascadeParallel();
+            return;
+        }
+        int index = cascadeStack.back();
+        cascadeStack.pop_back();
+        remainingCells--;
+        touched.push_back(index);
+        if (CellAt(index).adjacentMines != 0) {
+            continue;
+        }
+
+        int opening = openings.OpeningOf(index);
+        if (opening >= 0) {
+            openings.MarkTouched(opening);
+        }
+
+        int cellRow = index / cols;
+        int cellCol = index % cols;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                int newRow = cellRow + dr;
+                int newCol = cellCol + dc;
+                if (IsValidCell(newRow, newCol) &&
+                    At(newRow, newCol).state == CellState::HIDDEN) {
+                    SetState(Index(newRow, newCol), CellState::REVEALED);
+                    cascadeStack.push_back(Index(newRow, newCol));
+                }
+            }
+        }
+    }
+}
+
+void Board::RevealCascadeParallel() {
+    // The stacked cells are revealed but not yet counted or expanded; they become the first
+    // level of a breadth-first fill. Cell states stay untouched while levels are expanded,
+    // so threads only read them and claim new cells through the bitset.
+    for (int index : cascadeStack) {
+        remainingCells--;
+        touched.push_back(index);
+        int opening = openings.OpeningOf(index);
+        if (opening >= 0 && CellAt(index).adjacentMines == 0) {
+            openings.MarkTouched(opening);
+        }
+    }
+    cascadeLevel.swap(cascadeStack);
+    cascadeStack.clear();
+    revealBatch.clear();
+
+    while (!cascadeLevel.empty()) {
+        int levelSize = (int)cascadeLevel.size();
+        int chunkCount = (levelSize + CHUNK_CELLS - 1) / CHUNK_CELLS;
+        if ((int)chunkCells.size() < chunkCount) {
+            chunkCells.resize(chunkCount);
+        }
+        auto expand = [&](int chunk) {
+            std::vector<int>& next = chunkCells[chunk];
+            next.clear();
+            int end = std::min(levelSize, (chunk + 1) * CHUNK_CELLS);
+            for (int i = chunk * CHUNK_CELLS; i < end; ++i) {
+                int index = cascadeLevel[i];
+                int cellRow = index / cols;
+                int cellCol = index % cols;
+                if (At(cellRow, cellCol).adjacentMines != 0) {
+                    continue;
+                }
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        int newRow = cellRow + dr;
+                        int newCol = cellCol + dc;
+                        if (!IsValidCell(newRow, newCol)) continue;
+                        int newIndex = Index(newRow, newCol);
+                        if (At(newRow, newCol).state == CellState::HIDDEN && revealClaims.Claim(newIndex)) {
+                            next.push_back(newIndex);
+                        }
+                    }
+                }
+            }
+        };
+        // Levels shrink again as the fill runs out, and small ones aren't worth the threads
+        if (levelSize >= PARALLEL_CASCADE_MIN) {
+            ParallelFor(chunkCount, expand);
+        } else {
+            for (int chunk = 0; chunk < chunkCount; ++chunk) {
+                expand(chunk);
+            }
+        }
+
+        cascadeLevel.clear();
+        for (int chunk = 0; chunk < chunkCount; ++chunk) {
+            cascadeLevel.insert(cascadeLevel.end(), chunkCells[chunk].begin(), chunkCells[chunk].end());
+        }
+        revealBatch.insert(revealBatch.end(), cascadeLevel.begin(), cascadeLevel.end());
+    }
+
+    RevealBatch(revealBatch);
+    int batchSize = (int)revealBatch.size();
+    ParallelFor((batchSize + CHUNK_CELLS - 1) / CHUNK_CELLS, [&](int chunk) {
+        int end = std::min(batchSize, (chunk + 1) * CHUNK_CELLS);
+        for (int i = chunk * CHUNK_CELLS; i < end; ++i) {
+            revealClaims.ClearWordOf(revealBatch[i]);
+        }
+    });
+}
+
+void Board::RevealBatch(const std::vector<int>& batch) {
+    int batchSize = (int)batch.size();
+    if (batchSize < PARALLEL_REVEAL_MIN || WorkerCount() == 1) {
+        for (int index : batch) {
+            SetState(index, CellState::REVEALED);
+        }
+    } else {
+        // Write the states first, then recount the hidden neighbours of every cell around
+        // the batch once; each cell's counters are written by whichever thread claims it
+        int chunkCount = (batchSize + CHUNK_CELLS - 1) / CHUNK_CELLS;
+        ParallelFor(chunkCount, [&](int chunk) {
+            int end = std::min(batchSize, (chunk + 1) * CHUNK_CELLS);
+            for (int i = chunk * CHUNK_CELLS; i < end; ++i) {
+                CellAt(batch[i]).state = CellState::REVEALED;
+            }
+        });
+        auto forEachAround = [&](int chunk, auto visit) {
+            int end = std::min(batchSize, (chunk + 1) * CHUNK_CELLS);
+            for (int i = chunk * CHUNK_CELLS; i < end; ++i) {
+                int row = batch[i] / cols;
+                int col = batch[i] % cols;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        if ((dr != 0 || dc != 0) && IsValidCell(row + dr, col + dc)) {
+                            visit(Index(row + dr, col + dc));
+                        }
+                    }
+                }
+            }
+        };
+        ParallelFor(chunkCount, [&](int chunk) {
+            forEachAround(chunk, [&](int index) {
+                if (!recountMarks.Claim(index)) {
+                    return;
+                }
+                int row = index / cols;
+                int col = index % cols;
+                int hidden = 0;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        if ((dr != 0 || dc != 0) && IsValidCell(row + dr, col + dc) &&
+                            At(row + dr, col + dc).state == CellState::HIDDEN) {
+                            hidden++;
+                        }
+                    }
+                }
+                At(row, col).hiddenNeighbors = hidden;
+            });
+        });
+        ParallelFor(chunkCount, [&](int chunk) {
+            forEachAround(chunk, [&](int index) { recountMarks.ClearWordOf(index); });
+        });
+    }
+
+    remainingCells -= batchSize;
+    touched.insert(touched.end(), batch.begin(), batch.end());
+    for (int index : batch) {
+        int opening = openings.OpeningOf(index);
+        if (opening >= 0 && CellAt(index).adjacentMines == 0) {
+            openings.MarkTouched(opening);
+        }
+    }
+}
+
+RevealOutcome Board::RevealAdjacentCells(int row, int col, std::vector<int>* changed) {
+    BeginChange();
+    RevealOutcome outcome = RevealAdjacentCellsImpl(row, col);
+    EndChange(changed);
+    return outcome;
+}
+
+RevealOutcome Board::RevealAdjacentCellsImpl(int row, int col) {
+    // A revealed mine is not a number, so there is nothing to chord on
+    if (!IsValidCell(row, col) || At(row, col).state != CellState::REVEALED || At(row, col).hasMine) {
+        return RevealOutcome::NONE;
+    }
+
+    // Only chord if the number of flagged neighbors matches the adjacent mines count
+    const Cell& cell = At(row, col);
+    if (cell.flaggedNeighbors != cell.adjacentMines) {
+        return RevealOutcome::NONE;
+    }
+    bool mistakeMade = cell.misflaggedNeighbors > 0;
+    if (!mistakeMade && cell.hiddenNeighbors == 0) {
+        return RevealOutcome::NONE;  // Nothing left to reveal
+    }
+
+    version++;
+    if (mistakeMade) {
+        // Reveal only the neighboring mines to show the mistake
+        RevealNeighboringMinesImpl(row, col);
+        return RevealOutcome::HIT_MINE;
+    }
+
+    // Reveal all non-flagged adjacent cells
+    bool revealedAny = false;
+    for (int i = -1; i <= 1; i++) {
+        for (int j = -1; j <= 1; j++) {
+            if (i == 0 && j == 0) continue;
+
+            int newRow = row + i;
+            int newCol = col + j;
+
+            if (IsValidCell(newRow, newCol) &&
+                At(newRow, newCol).state == CellState::HIDDEN) {
+                if (At(newRow, newCol).hasMine) {
+                    // Hit a mine - reveal only neighboring mines
+                    RevealNeighboringMinesImpl(newRow, newCol);
+                    return RevealOutcome::HIT_MINE;
+                }
+                if (RevealCellImpl(newRow, newCol) != RevealOutcome::NONE) {
+                    revealedAny = true;
+                }
+            }
+        }
+    }
+
+    if (!revealedAny) {
+        return RevealOutcome::NONE;
+    }
+    return remainingCells == 0 ? RevealOutcome::WON : RevealOutcome::REVEALED;
+}
+
+bool Board::ToggleFlag(int row, int col) {
+    if (!IsValidCell(row, col)) {
+        return false;
+    }
+
+    Cell& cell = At(row, col);
+    int opening = openings.OpeningOf(Index(row, col));
+    if (cell.state == CellState::HIDDEN) {
+        SetState(Index(row, col), CellState::FLAGGED);
+        if (opening >= 0) {
+            openings.MarkTouched(opening);
+        }
+    } else if (cell.state == CellState::FLAGGED) {
+        SetState(Index(row, col), CellState::HIDDEN);
+        if (opening >= 0) {
+            openings.MarkUntouched(opening);
+        }
+    } else {
+        return false;
+    }
+
+    version++;
+    BeginChange();
+    touched.push_back(Index(row, col));
+    EndChange(nullptr);
+    return true;
+}
+
+void Board::RevealAllMines() {
+    version++;
+    ForEachCell([&](int row, int col, Cell& cell) {
+        if (cell.hasMine) {
+            SetState(Index(row, col), CellState::REVEALED);
+        }
+    });
+    frontier.Rebuild(*this);
+}
+
+void Board::RevealNeighboringMines(int row, int col) {
+    BeginChange();
+    RevealNeighboringMinesImpl(row, col);
+    EndChange(nullptr);
+}
+
+void Board::RevealNeighboringMinesImpl(int row, int col) {
+    version++;
+    // Check all 8 neighboring cells
+    for (int i = -1; i <= 1; i++) {
+        for (int j = -1; j <= 1; j++) {
+            if (i == 0 && j == 0) continue; // Skip the center cell
+
+            int newRow = row + i;
+            int newCol = col + j;
+
+            if (IsValidCell(newRow, newCol) && At(newRow, newCol).hasMine) {
+                SetState(Index(newRow, newCol), CellState::REVEALED);
+                touched.push_back(Index(newRow, newCol));
+#ifdef DEBUG
+                std::cout << "Revealed mine at (" << newRow << ", " << newCol << ")" << std::endl;
+#endif
+            }
+        }
+    }
+}
+
+RevealOutcome Board::CommitPlan(const RevealPlan& plan, std::vector<int>* changed) {
+    if (plan.outcome == RevealOutcome::NONE) {
+        return RevealOutcome::NONE;
+    }
+
+    version++;
+    BeginChange();
+    for (int index : plan.cells) {
+        Cell& cell = CellAt(index);
+        SetState(index, CellState::REVEALED);
+        touched.push_back(index);
+        if (cell.hasMine) {
+            continue;
+        }
+        remainingCells--;
+        if (cell.adjacentMines == 0) {
+            int opening = openings.OpeningOf(index);
+            if (opening >= 0) {
+                openings.MarkTouched(opening);
+            }
+        }
+    }
+    EndChange(changed);
+    return plan.outcome;
+}
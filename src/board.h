@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "openings.h"
+#include "frontier.h"
+#include "summary.h"
+#include "parallel.h"
+
+// Cell states
+enum class CellState : uint8_t {
+    HIDDEN,
+    REVEALED,
+    FLAGGED
+};
+
+// Byte-sized fields keep a cell at 6 bytes, a quarter of what int fields took, so four times
+// as many cells fit in each cache line. An 8-cell tile row is 48 bytes and may straddle two.
+struct Cell {
+    bool hasMine;
+    CellState state;
+    uint8_t adjacentMines;
+    // Kept up to date by the board on every state change
+    uint8_t flaggedNeighbors;
+    uint8_t hiddenNeighbors;      // Neighbours still hidden (flags not included)
+    uint8_t misflaggedNeighbors;  // Flagged neighbours without a mine
+};
+
+// What a reveal or chord did to the board
+enum class RevealOutcome {
+    NONE,       // Nothing changed
+    REVEALED,   // One or more safe cells were revealed
+    HIT_MINE,   // A mine was revealed (or a wrong flag was chorded)
+    WON         // The last safe cell was revealed
+};
+
+// Cells a reveal or chord would change, worked out without touching the board
+struct RevealPlan {
+    std::vector<int> cells;  // Cells that become revealed
+    RevealOutcome outcome;
+};
+
+// How cells are laid out in memory. Row-major keeps each row contiguous, so on long rows a
+// 3x3 neighbourhood spans three distant cache lines. Tiled stores 8x8 tiles contiguously with
+// the tiles in Morton (Z) order, so a neighbourhood usually sits in one or two tiles and
+// nearby tiles sit nearby in memory. Cell indices (Index, AtIndex) are row-major either way.
+enum class CellLayout {
+    ROW_MAJOR,
+    TILED
+};
+
+// Minesweeper rules without any rendering or audio, so the same rules can drive
+// the player's board and independent copies of it (e.g. a replay ghost).
+class Board
+{
+public:
+    Board();
+
+    // All cells hidden, no mines. Counters and indexes are left for RebuildIndexes, which
+    // callers run once they have set the cells (Generate does both).
+    void Reset(int rows, int cols);
+    void SetLayout(CellLayout layout) { this->layout = layout; }  // Applies from the next Reset or Generate
+    CellLayout Layout() const { return layout; }
+    // Same seed gives the same board. Rows are split into stripes generated in parallel,
+    // each from its own random stream, so the board doesn't depend on the thread count.
+    void Generate(int rows, int cols, int mineCount, unsigned int seed);
+    // The mines Generate would lay, as row-major indices passed to place (stripes may call it
+    // concurrently, each with its own indices). Returns the mine count after clamping.
+    static int PlaceMines(int rows, int cols, int mineCount, unsigned int seed, const std::function<void(int)>& place);
+    static int DefaultMineCount(int rows, int cols);  // The game's density: 15% of the cells, at least one
+    void CalculateAdjacentMines();
+    void RebuildIndexes();  // Call after changing mines or states directly (e.g. loading a game)
+
+    int Rows() const { return rows; }
+    int Cols() const { return cols; }
+    int Index(int row, int col) const { return row * cols + col; }
+    bool IsValidCell(int row, int col) const;
+    Cell& At(int row, int col) { return cells[Slot(row, col)]; }
+    const Cell& At(int row, int col) const { return cells[Slot(row, col)]; }
+    const Cell& AtIndex(int index) const { return cells[SlotOf(index)]; }
+
+    // Visit cells tile by tile as visit(row, col, cell); prefer these to row/column loops
+    // for passes that don't care about order, since they follow the storage
+    template <typename Visit> void ForEachCell(Visit visit) { ForEachCellIn(0, rows, 0, cols, visit); }
+    template <typename Visit> void ForEachCell(Visit visit) const { ForEachCellIn(0, rows, 0, cols, visit); }
+    template <typename Visit> void ForEachCellIn(int rowBegin, int rowEnd, int colBegin, int colEnd, Visit visit);
+    template <typename Visit> void ForEachCellIn(int rowBegin, int rowEnd, int colBegin, int colEnd, Visit visit) const;
+
+    // Optional "changed" receives the index of every cell that became revealed
+    RevealOutcome RevealCell(int row, int col, std::vector<int>* changed = nullptr);
+    RevealOutcome RevealAdjacentCells(int row, int col, std::vector<int>* changed = nullptr);  // Chord
+    bool ToggleFlag(int row, int col);  // Returns false if the cell can't be flagged
+    void RevealAllMines();
+    void RevealNeighboringMines(int row, int col);  // Reveal mines adjacent to a cell
+    RevealOutcome CommitPlan(const RevealPlan& plan, std::vector<int>* changed = nullptr);
+
+    int RemainingCells() const { return remainingCells; }
+    int FlagCount() const { return flagCount; }
+    bool IsSatisfied(int row, int col) const;  // Revealed number with exactly as many flags around it
+    void SetRemainingCells(int count) { remainingCells = count; version++; }  // Used when loading a saved game
+    unsigned int Version() const { return version; }  // Changes whenever any cell state changes
+    unsigned int Generation() const { return generation; }  // Changes when the board is replaced rather than played; unique across boards
+    const Frontier& GetFrontier() const { return frontier; }
+    // Per-tile counts for region queries, e.g. Summary().CountFlags(rowBegin, rowEnd, ...).
+    // Built on the first call after the board changes, so moves don't pay for it; not safe
+    // to call from two threads at once, though it is const.
+    const BoardSummary& Summary() const;
+
+private:
+    // The Impl versions collect the cells they change in "touched"; the public wrappers
+    // bracket them with BeginChange/EndChange so nested moves update the frontier once
+    RevealOutcome RevealCellImpl(int row, int col);
+    RevealOutcome RevealAdjacentCellsImpl(int row, int col);
+    void RevealNeighboringMinesImpl(int row, int col);
+    void RevealOpening(int opening);
+    void RevealCascade(int row, int col);
+    void RevealCascadeParallel();                // Finishes a cascade that outgrew the stack
+    void RevealBatch(const std::vector<int>& batch);  // Reveals distinct hidden safe cells
+    void SetState(int index, CellState state);  // Also updates the neighbours' counters
+    int Slot(int row, int col) const { return rowSlot[row] + colSlot[col]; }
+    int SlotOf(int index) const { return layout == CellLayout::ROW_MAJOR ? index : Slot(index / cols, index % cols); }
+    Cell& CellAt(int index) { return cells[SlotOf(index)]; }
+    void BuildLayout();
+    void CalculateNeighborCounts();
+    static std::vector<int> CornerCells(int rows, int cols);  // Distinct corner indices, ascending
+    void BeginChange();
+    void EndChange(std::vector<int>* changed);
+
+    int rows;
+    int cols;
+    CellLayout layout;
+    std::vector<Cell> cells;    // In storage order; tiled storage pads the edge tiles
+    std::vector<int> rowSlot;   // A cell's storage slot is rowSlot[row] + colSlot[col] in both layouts
+    std::vector<int> colSlot;
+    int remainingCells;
+    int flagCount;
+    unsigned int version;
+    unsigned int generation;
+    OpeningIndex openings;
+    std::vector<int> cascadeStack;  // Reused by RevealCascade
+    std::vector<int> cascadeLevel;  // Current level of a parallel cascade
+    std::vector<int> revealBatch;   // Cells a parallel cascade or an opening reveals
+    std::vector<std::vector<int>> chunkCells;  // Per-chunk output of a parallel step
+    AtomicBitset revealClaims;      // Cells a parallel cascade has claimed
+    AtomicBitset recountMarks;      // Cells whose counters a parallel batch has recounted
+    Frontier frontier;
+    mutable BoardSummary summary;   // Built by Summary(), for the version in summaryVersion
+    mutable unsigned int summaryVersion;
+    std::vector<int> touched;       // Cells changed by the move in progress
+};
+
+template <typename Visit>
+void Board::ForEachCellIn(int rowBegin, int rowEnd, int colBegin, int colEnd, Visit visit) {
+    if (layout == CellLayout::ROW_MAJOR) {
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            Cell* cell = &cells[Slot(row, colBegin)];
+            for (int col = colBegin; col < colEnd; ++col, ++cell) {
+                visit(row, col, *cell);
+            }
+        }
+        return;
+    }
+    // Within a tile row the columns are contiguous
+    for (int tileRow = rowBegin & ~7; tileRow < rowEnd; tileRow += 8) {
+        for (int tileCol = colBegin & ~7; tileCol < colEnd; tileCol += 8) {
+            int rowStart = std::max(rowBegin, tileRow);
+            int rowStop = std::min(rowEnd, tileRow + 8);
+            int colStart = std::max(colBegin, tileCol);
+            int colStop = std::min(colEnd, tileCol + 8);
+            for (int row = rowStart; row < rowStop; ++row) {
+                Cell* cell = &cells[Slot(row, colStart)];
+                for (int col = colStart; col < colStop; ++col, ++cell) {
+                    visit(row, col, *cell);
+                }
+            }
+        }
+    }
+}
+
+template <typename Visit>
+void Board::ForEachCellIn(int rowBegin, int rowEnd, int colBegin, int colEnd, Visit visit) const {
+    const_cast<Board*>(this)->ForEachCellIn(rowBegin, rowEnd, colBegin, colEnd,
+        [&](int row, int col, Cell& cell) { visit(row, col, static_cast<const Cell&>(cell)); });
+}
@@ -0,0 +1,244 @@
+#include <cstddef>
+
+#include "deduction.h"
+
+namespace {
+    // Cardinality encodings cost frontier size times bound, so only encode tight bounds
+    const int MINE_BOUND_LIMIT = 64;
+    // Auxiliary variables from old bounds pile up; start over past this many variables
+    const int MAX_SOLVER_VARS = 500000;
+}
+
+DeductionSolver::DeductionSolver()
+    : rows(0), cols(0), generation(0), unrevealedCount(0), boundSelector(-1)
+{
+}
+
+void DeductionSolver::Reset() {
+    solver.Clear();
+    rows = 0;
+    cols = 0;
+    cellVar.clear();
+    varCells.clear();
+    encoded.clear();
+    settled.clear();
+    boundSelector = -1;
+}
+
+int DeductionSolver::VarOf(int index) {
+    if (cellVar[index] < 0) {
+        cellVar[index] = solver.NewVar();
+        varCells.push_back(index);
+    }
+    return cellVar[index];
+}
+
+bool DeductionSolver::Sync(const Board& board) {
+    if (board.Rows() != rows || board.Cols() != cols || board.Generation() != generation ||
+        solver.VarCount() > MAX_SOLVER_VARS) {
+        Reset();
+        rows = board.Rows();
+        cols = board.Cols();
+        generation = board.Generation();
+        cellVar.assign(rows * cols, -1);
+        encoded.assign(rows * cols, 0);
+        settled.assign(rows * cols, 0);
+    }
+
+    // Only cells revealed since the last call add anything to the solver
+    unrevealedCount = 0;
+    for (int index = 0; index < rows * cols; ++index) {
+        const Cell& cell = board.AtIndex(index);
+        if (cell.state != CellState::REVEALED) {
+            unrevealedCount++;
+            continue;
+        }
+        if (cell.hasMine) {
+            return false;
+        }
+        if (cellVar[index] >= 0 && !settled[index]) {
+            solver.AddClause({ NegLit(cellVar[index]) });
+            settled[index] = 1;
+        }
+        if (!encoded[index]) {
+            EncodeNumber(board, index);
+            encoded[index] = 1;
+        }
+    }
+    return true;
+}
+
+void DeductionSolver::EncodeNumber(const Board& board, int index) {
+    int row = index / cols;
+    int col = index % cols;
+    int vars[8];
+    int count = 0;
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if ((dr == 0 && dc == 0) || !board.IsValidCell(row + dr, col + dc)) continue;
+            int neighbor = board.Index(row + dr, col + dc);
+            if (board.AtIndex(neighbor).state != CellState::REVEALED) {
+                vars[count++] = VarOf(neighbor);
+            }
+        }
+    }
+
+    // Exactly N of at most 8 cells: no N+1 of them are all mines, and no count-N+1 of them
+    // are all safe. Revealed neighbours were left out because they are known safe.
+    int mines = board.AtIndex(index).adjacentMines;
+    for (int mask = 0; mask < (1 << count); ++mask) {
+        int size = __builtin_popcount(mask);
+        if (size == mines + 1) {
+            clause.clear();
+            for (int i = 0; i < count; ++i) {
+                if (mask & (1 << i)) clause.push_back(NegLit(vars[i]));
+            }
+            solver.AddClause(clause);
+        }
+        if (size == count - mines + 1) {
+            clause.clear();
+            for (int i = 0; i < count; ++i) {
+                if (mask & (1 << i)) clause.push_back(PosLit(vars[i]));
+            }
+            solver.AddClause(clause);
+        }
+    }
+}
+
+void DeductionSolver::EncodeAtMost(const std::vector<int>& lits, int bound, int selector) {
+    // Sequential counter: counter[i][j] is true if at least j + 1 of lits[0..i] are true.
+    // Every clause carries the negated selector, so the constraint only holds while assumed.
+    int n = (int)lits.size();
+    int off = NegLit(selector);
+    if (bound == 0) {
+        for (int lit : lits) {
+            solver.AddClause({ off, lit ^ 1 });
+        }
+        return;
+    }
+
+    std::vector<int> previous(bound);
+    std::vector<int> current(bound);
+    for (int i = 0; i < n - 1; ++i) {
+        for (int j = 0; j < bound; ++j) {
+            current[j] = solver.NewVar();
+        }
+        solver.AddClause({ off, lits[i] ^ 1, PosLit(current[0]) });
+        if (i == 0) {
+            for (int j = 1; j < bound; ++j) {
+                solver.AddClause({ off, NegLit(current[j]) });
+            }
+        } else {
+            solver.AddClause({ off, NegLit(previous[0]), PosLit(current[0]) });
+            for (int j = 1; j < bound; ++j) {
+                solver.AddClause({ off, lits[i] ^ 1, NegLit(previous[j - 1]), PosLit(current[j]) });
+                solver.AddClause({ off, NegLit(previous[j]), PosLit(current[j]) });
+            }
+            solver.AddClause({ off, lits[i] ^ 1, NegLit(previous[bound - 1]) });
+        }
+        previous.swap(current);
+    }
+    if (n > 1) {
+        solver.AddClause({ off, lits[n - 1] ^ 1, NegLit(previous[bound - 1]) });
+    }
+}
+
+bool DeductionSolver::EncodeMineBounds(int totalMines, int& selector) {
+    // The previous bound was for another position; switching its selector off retires it
+    selector = -1;
+    if (boundSelector >= 0) {
+        solver.AddClause({ NegLit(boundSelector) });
+        boundSelector = -1;
+    }
+
+    std::vector<int> lits;
+    for (int cell : varCells) {
+        if (!settled[cell]) {
+            lits.push_back(PosLit(cellVar[cell]));
+        }
+    }
+    int frontierCount = (int)lits.size();
+    int interiorCount = unrevealedCount - frontierCount;
+    int upper = totalMines;                   // Mines the frontier can hold at most
+    int lower = totalMines - interiorCount;   // and at least, if the rest is full of mines
+    if (upper < 0 || lower > frontierCount) {
+        return false;  // More mines than unrevealed cells, or fewer than none
+    }
+
+    // Each bound is encoded only when it lies in [0, frontierCount) and so actually constrains
+    bool useUpper = upper < frontierCount && upper <= MINE_BOUND_LIMIT;
+    bool useLower = lower > 0 && frontierCount - lower <= MINE_BOUND_LIMIT;
+    if (!useUpper && !useLower) {
+        return true;
+    }
+
+    boundSelector = solver.NewVar();
+    if (useUpper) {
+        EncodeAtMost(lits, upper, boundSelector);
+    }
+    if (useLower) {
+        for (int& lit : lits) {
+            lit ^= 1;
+        }
+        EncodeAtMost(lits, frontierCount - lower, boundSelector);
+    }
+    selector = boundSelector;
+    return true;
+}
+
+bool DeductionSolver::Analyze(const Board& board, int totalMines, Deductions& out) {
+    out.safe.clear();
+    out.mines.clear();
+    if (!Sync(board)) {
+        return false;
+    }
+
+    assumptions.clear();
+    int selector;
+    if (!EncodeMineBounds(totalMines, selector)) {
+        return false;
+    }
+    if (selector >= 0) {
+        assumptions.push_back(PosLit(selector));
+    }
+    if (solver.Solve(assumptions) == SatResult::UNSAT) {
+        return false;
+    }
+
+    // A cell is forced only if it has the same value in every model. Each satisfying model
+    // found along the way rules out every candidate it disagrees with.
+    candidates.clear();
+    for (int cell : board.GetFrontier().Unknowns().Items()) {
+        int var = cellVar[cell];
+        int fixed = solver.FixedValue(var);
+        if (fixed >= 0) {
+            (fixed ? out.mines : out.safe).push_back(cell);
+        } else {
+            candidates.push_back({ cell, var, solver.ModelValue(var), true });
+        }
+    }
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        Candidate& candidate = candidates[i];
+        if (!candidate.open) continue;
+
+        int forcedLit = candidate.value ? PosLit(candidate.var) : NegLit(candidate.var);
+        assumptions.push_back(forcedLit ^ 1);
+        SatResult result = solver.Solve(assumptions);
+        assumptions.pop_back();
+
+        if (result == SatResult::UNSAT) {
+            (candidate.value ? out.mines : out.safe).push_back(candidate.cell);
+            if (selector < 0) {
+                solver.AddClause({ forcedLit });  // Follows from the numbers alone, so keep it
+            }
+            continue;
+        }
+        for (size_t j = i + 1; j < candidates.size(); ++j) {
+            if (candidates[j].open && solver.ModelValue(candidates[j].var) != candidates[j].value) {
+                candidates[j].open = false;
+            }
+        }
+    }
+    return true;
+}
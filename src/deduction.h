@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+#include "board.h"
+#include "sat.h"
+
+// Frontier cells whose contents follow from the visible numbers
+struct Deductions {
+    std::vector<int> safe;   // Hidden cells that cannot hold a mine
+    std::vector<int> mines;  // Hidden cells that must hold a mine
+};
+
+// Exact deduction for frontiers too tangled to enumerate. Every revealed number becomes an
+// "exactly N of these cells" constraint in a SAT solver, once, when it first appears; later
+// moves only add what changed, so the solver and everything it has learnt carry over from
+// move to move. The total mine count is added as a cardinality constraint when it can
+// matter (in the endgame), behind a selector literal so it can be replaced after each move.
+// Flags are player guesses, so flagged cells are treated as unknowns.
+class DeductionSolver
+{
+public:
+    DeductionSolver();
+
+    void Reset();
+    // Returns false if the board shows a revealed mine or contradicts itself
+    bool Analyze(const Board& board, int totalMines, Deductions& out);
+
+private:
+    bool Sync(const Board& board);
+    int VarOf(int index);
+    void EncodeNumber(const Board& board, int index);
+    void EncodeAtMost(const std::vector<int>& lits, int bound, int selector);
+    // False if totalMines can't fit the unrevealed cells; selector is -1 when no bound was needed
+    bool EncodeMineBounds(int totalMines, int& selector);
+
+    SatSolver solver;
+    int rows;
+    int cols;
+    unsigned int generation;
+    std::vector<int> cellVar;   // Per cell: solver variable, -1 if none yet
+    std::vector<int> varCells;  // Cells that have a variable
+    std::vector<char> encoded;  // Per cell: number constraint added
+    std::vector<char> settled;  // Per cell: known safe because it was revealed
+    int unrevealedCount;
+    int boundSelector;          // Selector of the current mine-count constraint, -1 if none
+
+    struct Candidate {
+        int cell;
+        int var;
+        bool value;  // Value in the models seen so far
+        bool open;   // Still possibly forced
+    };
+    std::vector<Candidate> candidates;
+    std::vector<int> assumptions;
+    std::vector<int> clause;
+};
@@ -0,0 +1,180 @@
+#include <algorithm>
+
+#include "frontier.h"
+#include "board.h"
+#include "parallel.h"
+
+void IndexedSet::Reset(int cellCount) {
+    items.clear();
+    position.assign(cellCount, -1);
+}
+
+void IndexedSet::Insert(int index) {
+    if (position[index] >= 0) {
+        return;
+    }
+    position[index] = (int)items.size();
+    items.push_back(index);
+}
+
+void IndexedSet::Erase(int index) {
+    int pos = position[index];
+    if (pos < 0) {
+        return;
+    }
+    // Move the last item into the hole so erasing stays O(1)
+    int last = items.back();
+    items[pos] = last;
+    position[last] = pos;
+    items.pop_back();
+    position[index] = -1;
+}
+
+void Frontier::Rebuild(const Board& board) {
+    int cellCount = board.Rows() * board.Cols();
+    unknowns.Reset(cellCount);
+    numbers.Reset(cellCount);
+
+    // Classify stripes in parallel, then insert in row-major order as a plain sweep would
+    int stripeCount = StripeCount(board.Rows());
+    std::vector<std::vector<int>> stripeUnknowns(stripeCount);
+    std::vector<std::vector<int>> stripeNumbers(stripeCount);
+    ParallelFor(stripeCount, [&](int stripe) {
+        int rowEnd = std::min(board.Rows(), (stripe + 1) * STRIPE_ROWS);
+        for (int row = stripe * STRIPE_ROWS; row < rowEnd; ++row) {
+            for (int col = 0; col < board.Cols(); ++col) {
+                bool isUnknown;
+                bool isNumber;
+                Classify(board, row, col, isUnknown, isNumber);
+                if (isUnknown) stripeUnknowns[stripe].push_back(board.Index(row, col));
+                if (isNumber) stripeNumbers[stripe].push_back(board.Index(row, col));
+            }
+        }
+    });
+    for (int stripe = 0; stripe < stripeCount; ++stripe) {
+        for (int index : stripeUnknowns[stripe]) unknowns.Insert(index);
+        for (int index : stripeNumbers[stripe]) numbers.Insert(index);
+    }
+}
+
+void Frontier::Update(const Board& board, const std::vector<int>& changedCells) {
+    // Refreshing a 3x3 block per changed cell costs more than a striped rebuild once a
+    // move has changed a large part of the board (a giant opening)
+    int cols = board.Cols();
+    if ((long long)changedCells.size() * 8 > (long long)board.Rows() * cols) {
+        Rebuild(board);
+        return;
+    }
+    for (int index : changedCells) {
+        int row = index / cols;
+        int col = index % cols;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (board.IsValidCell(row + dr, col + dc)) {
+                    Refresh(board, row + dr, col + dc);
+                }
+            }
+        }
+    }
+}
+
+void Frontier::Classify(const Board& board, int row, int col, bool& isUnknown, bool& isNumber) {
+    const Cell& cell = board.At(row, col);
+
+    isUnknown = false;
+    isNumber = cell.state == CellState::REVEALED && !cell.hasMine && cell.hiddenNeighbors > 0;
+    if (cell.state == CellState::HIDDEN) {
+        for (int dr = -1; dr <= 1 && !isUnknown; ++dr) {
+            for (int dc = -1; dc <= 1 && !isUnknown; ++dc) {
+                if ((dr == 0 && dc == 0) || !board.IsValidCell(row + dr, col + dc)) continue;
+                const Cell& neighbor = board.At(row + dr, col + dc);
+                isUnknown = neighbor.state == CellState::REVEALED && !neighbor.hasMine;
+            }
+        }
+    }
+}
+
+void Frontier::Refresh(const Board& board, int row, int col) {
+    int index = board.Index(row, col);
+    bool isUnknown;
+    bool isNumber;
+    Classify(board, row, col, isUnknown, isNumber);
+    if (isUnknown) unknowns.Insert(index); else unknowns.Erase(index);
+    if (isNumber) numbers.Insert(index); else numbers.Erase(index);
+}
+
+void Frontier::Components(const Board& board, std::vector<FrontierComponent>& out) const {
+    out.clear();
+    int cellCount = board.Rows() * board.Cols();
+    if ((int)parent.size() != cellCount) {
+        parent.resize(cellCount);
+    }
+
+    auto find = [this](int index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    };
+
+    // Only frontier cells are initialised, so the cost stays proportional to the frontier
+    for (int index : unknowns.Items()) {
+        parent[index] = index;
+    }
+
+    // Every unknown next to the same number belongs to the same component
+    int cols = board.Cols();
+    for (int number : numbers.Items()) {
+        int row = number / cols;
+        int col = number % cols;
+        int first = -1;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (!board.IsValidCell(row + dr, col + dc)) continue;
+                int neighbor = board.Index(row + dr, col + dc);
+                if (!unknowns.Contains(neighbor)) continue;
+                if (first < 0) {
+                    first = find(neighbor);
+                } else {
+                    parent[find(neighbor)] = first;
+                }
+            }
+        }
+    }
+
+    // Give each root a component id in first-seen order
+    if ((int)componentOf.size() != cellCount) {
+        componentOf.resize(cellCount);
+    }
+    for (int index : unknowns.Items()) {
+        componentOf[find(index)] = -1;
+    }
+    for (int index : unknowns.Items()) {
+        int root = find(index);
+        if (componentOf[root] < 0) {
+            componentOf[root] = (int)out.size();
+            out.emplace_back();
+        }
+        out[componentOf[root]].unknowns.push_back(index);
+    }
+
+    // A number belongs to the component of any unknown it touches
+    for (int number : numbers.Items()) {
+        int row = number / cols;
+        int col = number % cols;
+        int component = -1;
+        for (int dr = -1; dr <= 1 && component < 0; ++dr) {
+            for (int dc = -1; dc <= 1 && component < 0; ++dc) {
+                if (!board.IsValidCell(row + dr, col + dc)) continue;
+                int neighbor = board.Index(row + dr, col + dc);
+                if (unknowns.Contains(neighbor)) {
+                    component = componentOf[find(neighbor)];
+                }
+            }
+        }
+        if (component >= 0) {
+            out[component].numbers.push_back(number);
+        }
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+class Board;
+
+// Set of cell indices with O(1) insert, erase and membership, iterable in O(size)
+class IndexedSet
+{
+public:
+    void Reset(int cellCount);
+    bool Contains(int index) const { return position[index] >= 0; }
+    void Insert(int index);
+    void Erase(int index);
+    int Size() const { return (int)items.size(); }
+    const std::vector<int>& Items() const { return items; }
+
+private:
+    std::vector<int> items;
+    std::vector<int> position;  // Position of each cell in items, -1 if absent
+};
+
+// Unknown cells and the numbers constraining them, with the numbers that touch them
+struct FrontierComponent {
+    std::vector<int> unknowns;
+    std::vector<int> numbers;
+};
+
+// The frontier of the visible board: hidden cells next to a revealed cell, and revealed
+// cells next to a hidden cell. Flagged cells count as placed mines, not as unknowns.
+// The board keeps it up to date from the cells each move changed, so frontier queries
+// cost O(frontier) instead of a scan of the whole grid.
+class Frontier
+{
+public:
+    void Rebuild(const Board& board);
+    void Update(const Board& board, const std::vector<int>& changedCells);
+
+    const IndexedSet& Unknowns() const { return unknowns; }
+    const IndexedSet& Numbers() const { return numbers; }
+
+    // Groups of unknowns linked through shared numbers; each group can be solved on its own
+    void Components(const Board& board, std::vector<FrontierComponent>& out) const;
+
+private:
+    static void Classify(const Board& board, int row, int col, bool& isUnknown, bool& isNumber);
+    void Refresh(const Board& board, int row, int col);
+
+    IndexedSet unknowns;
+    IndexedSet numbers;
+    mutable std::vector<int> parent;       // Union-find scratch space for Components
+    mutable std::vector<int> componentOf;  // Root -> component id, scratch space for Components
+};
@@ -8,6 +8,7 @@
 #include <algorithm>  // For std::max
 
 #include "raylib.h"
+#include "rlgl.h"  // For rlSetBlendFactorsSeparate
 #include "globals.h"
 #include "game.h"
 
@@ -16,17 +17,80 @@
 #endif
 
 const float Game::LONG_TAP_THRESHOLD = 0.3f;
+const float Game::SATISFIED_NUMBER_ALPHA = 0.45f;
+const double Game::SPECULATION_BUDGET = 0.002;
+const double Game::GUESS_BUDGET = 0.1;
+const double Game::GENERATION_BUDGET = 0.05;
+const float Game::TARGET_LEVEL_SECONDS = 60.0f;
+const float Game::INITIAL_PLAYER_SPEED = 0.5f;
+const float Game::PLAYER_SPEED_SMOOTHING = 0.3f;
+const float Game::FRAME_BUDGET = 1.0f / 60.0f;  // main.cpp's SetTargetFPS(60)
 
 bool Game::isMobile = false;
 
+namespace {
+    // FNV-1a over the values a layer is drawn from
+    class KeyHash
+    {
+    public:
+        KeyHash() : hash(14695981039346656037ULL) {}
+        KeyHash& Add(const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 1099511628211ULL;
+            }
+            return *this;
+        }
+        template <typename T> KeyHash& operator<<(const T& value) { return Add(&value, sizeof(value)); }
+        KeyHash& operator<<(const std::string& text) { return Add(text.data(), text.size()) << text.size(); }
+        uint64_t Value() const { return hash; }
+
+    private:
+        uint64_t hash;
+    };
+
+    // Colors are stored premultiplied and coverage adds up in alpha, so translucent drawing
+    // into a layer composites as if it had been drawn directly into the frame
+    void BeginPremultipliedBlend() {
+        rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE, RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD, RL_FUNC_ADD);
+        BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+    }
+
+    // Effect tuning, in game screen pixels and seconds
+    const uint32_t FIRE_COLORS[] = { 0xff2040ffu, 0xff0080ffu, 0xff00c0ffu, 0xff60f0ffu };  // RGBA words, red low
+    const uint32_t CONFETTI_COLORS[] = { 0xff4040ffu, 0xff40c0ffu, 0xff40ff60u, 0xffffc040u, 0xffff40c0u, 0xff40ffffu };
+    const int HIT_SPARKS = 256;          // From the mine that was hit
+    const int MAX_SPARKS_PER_MINE = 12;
+    const float SPARK_GRAVITY = 400.0f;
+    const float SPARK_DRAG = 2.5f;
+    const int CONFETTI_PIECES = 1200;
+    const float CONFETTI_GRAVITY = 300.0f;
+    const float CONFETTI_DRAG = 1.5f;
+
+    const int SHOWN_SPLITS = 8;  // Latest speedrun splits listed under the win banner
+
+    const uint64_t STALE_HINTS = ~0ULL;  // hintsKey that no board matches, so hints are recomputed
+
+    bool SameTarget(const DifficultyTarget& a, const DifficultyTarget& b) {
+        return a.min3bv == b.min3bv && a.max3bv == b.max3bv && a.minGuesses == b.minGuesses &&
+               a.maxGuesses == b.maxGuesses && a.minDepth == b.minDepth && a.maxDepth == b.maxDepth;
+    }
+}
+
 Game::Game(int screenWidth, int screenHeight)
     : screenWidth(screenWidth), screenHeight(screenHeight), gameOver(false), gameWon(false),
       gameOverTextTimer(0.0f),  // Initialize game over text timer
       isMenuBarHovered(false), isFileMenuOpen(false), isHelpMenuOpen(false), isOptionsMenuOpen(false), showHelpPopup(false),
       showCustomGamePopup(false), showSavePopup(false), showLoadPopup(false), showWelcomePopup(true),  // Show welcome popup at start
-      gameTime(0.0f), remainingMines(0), currentGridSize(isMobile ? MOBILE_INITIAL_GRID_SIZE : DESKTOP_INITIAL_GRID_SIZE), customGridSizeInputLength(0),
+      gameTime(0.0f), remainingMines(0), boardSeed(0), currentGridSize(isMobile ? MOBILE_INITIAL_GRID_SIZE : DESKTOP_INITIAL_GRID_SIZE), customGridSizeInputLength(0),
       filenameInputLength(0), isTapping(false), tapStartTime(0.0f), tapStartPos({0, 0}), tapRow(-1), tapCol(-1),
-      longTapPerformed(false), waitingForNextLevel(false), waitingForGameOver(false), isMusicPlaying(false)
+      longTapPerformed(false), waitingForNextLevel(false), waitingForGameOver(false), resolution(FRAME_BUDGET),
+      isMusicPlaying(false), ghostActive(false), speedrunMode(false), inputTimestampNs(0),
+      assistMode(false), showHints(false), hintsKey(STALE_HINTS), hintGuess(-1), guessTaskKey(STALE_HINTS), guessPending(false),
+      adaptiveMode(false), preparedSize(0), preparedMineCount(0), preparedTarget(),
+      boardValue(0), playerSpeed(INITIAL_PLAYER_SPEED), difficultyLevel(0),
+      showHeatmap(false), heatmapSavedVersion(0), heatmapTexVersion(0), heatmapTexSize(0),
+      particleGravity(0.0f), particleDrag(0.0f), particlesDrawn(false)
 {
 #ifdef DEBUG
     std::cout << "Game constructor: Initializing with screen size " << screenWidth << "x" << screenHeight << std::endl;
@@ -39,11 +103,41 @@ Game::Game(int screenWidth, int screenHeight)
 #endif
     currentGridSize = isMobile ? MOBILE_INITIAL_GRID_SIZE : DESKTOP_INITIAL_GRID_SIZE;
     screenScale = MIN((float)GetScreenWidth() / gameScreenWidth, (float)GetScreenHeight() / gameScreenHeight);
-    targetRenderTex = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
-    SetTextureFilter(targetRenderTex.texture, TEXTURE_FILTER_BILINEAR); // Texture scale filter to use
+    targetRenderTex = RenderTexture2D{};
+    for (int i = 0; i < LAYER_COUNT; ++i) {
+        layerTex[i] = RenderTexture2D{};
+        layerKeys[i] = 0;
+    }
+    ResizeRenderTargets();
+    ghostOverlayTex = LoadRenderTexture(gameScreenWidth, gameScreenHeight);
+
+    // Clicks from earlier sessions, and a blank texture the viewer fills in place
+    heatmap.Load(HEATMAP_FILE);
+    heatmapSavedVersion = heatmap.Version();
+    heatmapPixels.assign(ClickHeatmap::RESOLUTION * ClickHeatmap::RESOLUTION, BLANK);
+    Image heatmapImage = GenImageColor(ClickHeatmap::RESOLUTION, ClickHeatmap::RESOLUTION, BLANK);
+    heatmapTex = LoadTextureFromImage(heatmapImage);
+    UnloadImage(heatmapImage);
+    SetTextureFilter(heatmapTex, TEXTURE_FILTER_POINT);  // Sharp cell edges
+
+    // Particle sprites: a soft round spark with alpha falling off to the edge, and a solid
+    // square for confetti, both white so the particle colors tint them
+    std::vector<Color> atlasPixels(PARTICLE_SPRITE_SIZE * 2 * PARTICLE_SPRITE_SIZE, WHITE);
+    float radius = PARTICLE_SPRITE_SIZE * 0.5f;
+    for (int y = 0; y < PARTICLE_SPRITE_SIZE; ++y) {
+        for (int x = 0; x < PARTICLE_SPRITE_SIZE; ++x) {
+            float falloff = MAX(0.0f, 1.0f - sqrtf((x + 0.5f - radius) * (x + 0.5f - radius) +
+                                                   (y + 0.5f - radius) * (y + 0.5f - radius)) / radius);
+            atlasPixels[y * PARTICLE_SPRITE_SIZE * 2 + x].a = (unsigned char)(255.0f * falloff * falloff);
+        }
+    }
+    Image atlasImage = GenImageColor(PARTICLE_SPRITE_SIZE * 2, PARTICLE_SPRITE_SIZE, BLANK);
+    particleAtlas = LoadTextureFromImage(atlasImage);
+    UnloadImage(atlasImage);
+    UpdateTexture(particleAtlas, atlasPixels.data());
+    SetTextureFilter(particleAtlas, TEXTURE_FILTER_BILINEAR);
     font = LoadFontEx("Font/monogram.ttf", 64, 0, 0);    
     LoadTextures();
-    InitializeGrid();
     Randomize();
 #ifdef DEBUG
     InitializeDebugGrid();
@@ -76,6 +170,15 @@ Game::~Game()
 {
     UnloadTextures();
     UnloadRenderTexture(targetRenderTex);
+    UnloadRenderTexture(ghostOverlayTex);
+    for (int i = 0; i < LAYER_COUNT; ++i) {
+        UnloadRenderTexture(layerTex[i]);
+    }
+    UnloadTexture(heatmapTex);
+    UnloadTexture(particleAtlas);
+    if (heatmap.Version() != heatmapSavedVersion) {
+        heatmap.Save(HEATMAP_FILE);
+    }
     UnloadFont(font);
     StopMusicStream(backgroundMusic);
     UnloadMusicStream(backgroundMusic);
@@ -85,6 +188,9 @@ Game::~Game()
 
 void Game::Update(float dt)
 {
+    // Input events were polled at the end of the last frame, so stamp them before doing any work
+    inputTimestampNs = SpeedrunTimer::NowNs();
+
     try {
         UpdateUI();
         bool menuHandledClick = HandleMenuInput();
@@ -95,6 +201,11 @@ void Game::Update(float dt)
             UpdateMusicStream(backgroundMusic);
         }
 
+        // The next adaptive board is generated while the player takes in how this one ended
+        if (gameOver) {
+            PrepareAdaptiveBoard();
+        }
+
         // If help popup or custom game popup is shown, ignore all game input
         if (showHelpPopup || showCustomGamePopup || showSavePopup || showLoadPopup) {
             return;
@@ -108,6 +219,10 @@ void Game::Update(float dt)
         // Update game time if game is not over and welcome popup is not shown
         if (!gameOver && !gameWon && !showWelcomePopup) {
             gameTime += dt;
+            UpdateGhost();
+            if (showHints) {
+                UpdateHints();
+            }
         }
 
         // Update game over text timer
@@ -116,15 +231,7 @@ void Game::Update(float dt)
         }
 
         // Update remaining mines count
-        int flaggedCount = 0;
-        for (int row = 0; row < currentGridSize; ++row) {
-            for (int col = 0; col < currentGridSize; ++col) {
-                if (grid[row][col].state == CellState::FLAGGED) {
-                    flaggedCount++;
-                }
-            }
-        }
-        remainingMines = CalculateMineCount() - flaggedCount;
+        remainingMines = CalculateMineCount() - board.FlagCount();
 
         // Update scaling if window size changed
         if (IsWindowResized()) {
@@ -148,6 +255,10 @@ void Game::Update(float dt)
         bool isInGrid = (gameX >= gridOffset.x && gameX < gridOffset.x + currentGridSize * cellSize &&
                         gameY >= gridOffset.y && gameY < gridOffset.y + currentGridSize * cellSize);
 
+        if (!gameOver && isInGrid) {
+            UpdateSpeculation(row, col);
+        }
+
         if (gameOver) {
             // If game is over, any click in the game area starts a new game
             if (isInGrid) {
@@ -175,37 +286,32 @@ void Game::Update(float dt)
                 isTapping = false;
                 
                 // Check if tap was in the same cell
-                if (tapRow == row && tapCol == col && IsValidCell(row, col)) {
+                if (tapRow == row && tapCol == col && board.IsValidCell(row, col)) {
                     float tapDuration = gameTime - tapStartTime;
                     
-                    if (grid[row][col].state == CellState::HIDDEN) {
+                    if (board.At(row, col).state == CellState::HIDDEN) {
                         if (tapDuration < LONG_TAP_THRESHOLD) {
                             // Short tap - reveal cell
                             RevealCell(row, col);
                         }
-                    } else if (grid[row][col].state == CellState::FLAGGED) {
+                    } else if (board.At(row, col).state == CellState::FLAGGED) {
                         if (tapDuration >= LONG_TAP_THRESHOLD && !longTapPerformed) {
                             // Long tap on flagged cell - unflag it
-                            grid[row][col].state = CellState::HIDDEN;
+                            ToggleFlag(row, col);
                         }
-                    } else if (grid[row][col].state == CellState::REVEALED && grid[row][col].adjacentMines > 0) {
+                    } else if (board.At(row, col).state == CellState::REVEALED && board.At(row, col).adjacentMines > 0) {
                         // Tap on numbered cell - reveal adjacent cells
                         RevealAdjacentCells(row, col);
                     }
                 }
             }
-            else if (isTapping && IsValidCell(tapRow, tapCol)) {
+            else if (isTapping && board.IsValidCell(tapRow, tapCol)) {
                 // Check if we're still holding the tap
                 float tapDuration = gameTime - tapStartTime;
                 
                 if (tapDuration >= LONG_TAP_THRESHOLD && !longTapPerformed) {
-                    if (grid[tapRow][tapCol].state == CellState::HIDDEN) {
-                        // Show flag when timer expires on hidden cell
-                        grid[tapRow][tapCol].state = CellState::FLAGGED;
-                        longTapPerformed = true;
-                    } else if (grid[tapRow][tapCol].state == CellState::FLAGGED) {
-                        // Remove flag when timer expires on flagged cell
-                        grid[tapRow][tapCol].state = CellState::HIDDEN;
+                    // Show or remove the flag when timer expires on a hidden or flagged cell
+                    if (ToggleFlag(tapRow, tapCol)) {
                         longTapPerformed = true;
                     }
                 }
@@ -213,11 +319,11 @@ void Game::Update(float dt)
         } else {
             // Desktop controls
             if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !menuHandledClick) {
-                if (IsValidCell(row, col)) {
-                    if (grid[row][col].state == CellState::HIDDEN) {
+                if (board.IsValidCell(row, col)) {
+                    if (board.At(row, col).state == CellState::HIDDEN) {
                         RevealCell(row, col);
                     }
-                    else if (grid[row][col].state == CellState::REVEALED && grid[row][col].adjacentMines > 0) {
+                    else if (board.At(row, col).state == CellState::REVEALED && board.At(row, col).adjacentMines > 0) {
                         // Check if right button is also pressed
                         if (IsMouseButtonDown(MOUSE_RIGHT_BUTTON)) {
                             RevealAdjacentCells(row, col);
@@ -226,16 +332,13 @@ void Game::Update(float dt)
                 }
             }
             else if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && !menuHandledClick) {
-                if (IsValidCell(row, col)) {
-                    if (grid[row][col].state == CellState::HIDDEN) {
-                        grid[row][col].state = CellState::FLAGGED;
-                        PlaySound(actionSound);  // Play action sound for flagging
-                    }
-                    else if (grid[row][col].state == CellState::FLAGGED) {
-                        grid[row][col].state = CellState::HIDDEN;
-                        PlaySound(actionSound);  // Play action sound for unflagging
+                if (board.IsValidCell(row, col)) {
+                    if (board.At(row, col).state != CellState::REVEALED) {
+                        if (ToggleFlag(row, col)) {
+                            PlaySound(actionSound);  // Play action sound for flagging/unflagging
+                        }
                     }
-                    else if (grid[row][col].state == CellState::REVEALED && grid[row][col].adjacentMines > 0) {
+                    else if (board.At(row, col).adjacentMines > 0) {
                         // Check if left button is also pressed
                         if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
                             RevealAdjacentCells(row, col);
@@ -281,10 +384,28 @@ void Game::DrawUI() {
     DrawText(minesText.c_str(), gridOffset.x, gridOffset.y - statsHeight, fontSize, WHITE);
     
     // Draw timer
-    std::string timeText = "Timer: " + std::to_string((int)gameTime);
+    std::string timeText = TimerText();
     int timeTextWidth = MeasureText(timeText.c_str(), fontSize);
     DrawText(timeText.c_str(), gridOffset.x + currentGridSize * cellSize - timeTextWidth, gridOffset.y - statsHeight, fontSize, WHITE);
 
+    // Draw ghost progress while racing
+    if (ghostActive) {
+        std::string ghostText = "Ghost: " + std::to_string(ghostBoard.RemainingCells()) + " left";
+        int ghostTextWidth = MeasureText(ghostText.c_str(), fontSize);
+        DrawText(ghostText.c_str(), gridOffset.x + (currentGridSize * cellSize - ghostTextWidth) / 2, gridOffset.y - statsHeight, fontSize, SKYBLUE);
+    }
+}
+
+std::string Game::TimerText() const {
+    if (speedrunMode) {
+        int64_t nowNs = SpeedrunTimer::NowNs();
+        return "Level " + SpeedrunTimer::FormatTime(speedrun.LevelTimeNs(nowNs)) +
+               "  Run " + SpeedrunTimer::FormatTime(speedrun.RunTimeNs(nowNs));
+    }
+    return "Timer: " + std::to_string((int)gameTime);
+}
+
+void Game::DrawPopups() {
     // Draw welcome popup if active
     if (showWelcomePopup) {
         // Draw semi-transparent background
@@ -519,28 +640,244 @@ void Game::DrawUI() {
         DrawText(okText, okButtonRect.x + (okButtonRect.width - okTextWidth) / 2, 
                 okButtonRect.y + 5, 20, BLACK);
     }
-
-    DrawMenuBar();
 }
 
 void Game::Draw(float dt)
 {
     // Update scale based on current window size
     scale = MIN((float)GetScreenWidth() / gameScreenWidth, (float)GetScreenHeight() / gameScreenHeight);
-    
-    // Render to texture
-    BeginTextureMode(targetRenderTex);
-    ClearBackground(RAYWHITE);
-    
-    // Draw background
-    DrawTexturePro(backgroundTexture,
-        (Rectangle){0, 0, (float)backgroundTexture.width, (float)backgroundTexture.height},
-        (Rectangle){0, 0, (float)gameScreenWidth, (float)gameScreenHeight},
+
+    // Step the render resolution down when frames run over budget and back up with headroom
+    if (resolution.Update(dt)) {
+#ifdef DEBUG
+        std::cout << "Render scale " << resolution.Scale() << " at " << resolution.AverageFrameTime() * 1000.0f << " ms per frame" << std::endl;
+#endif
+        ResizeRenderTargets();
+    }
+
+    // Update timer for text fade effect
+    if (gameOver && !gameWon) {
+        gameOverTextTimer += dt;
+    }
+    if (showHeatmap) {
+        UpdateHeatmapTexture();
+    }
+    particles.Update(dt, particleGravity, particleDrag);
+    bool animating = !particles.Empty();
+
+    // Repaint the layers whose state changed, and composite only if any did or particles
+    // are moving (or have just gone and must be cleared from the frame)
+    bool changed = false;
+    for (int i = 0; i < LAYER_COUNT; ++i) {
+        Layer layer = (Layer)i;
+        uint64_t key = LayerKey(layer);
+        if (layerDirty[layer] || key != layerKeys[layer]) {
+            PaintLayer(layer);
+            layerKeys[layer] = key;
+            layerDirty[layer] = false;
+            changed = true;
+        }
+    }
+    if (changed || animating || particlesDrawn) {
+        BeginTextureMode(targetRenderTex);
+        BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+        for (int i = 0; i < LAYER_COUNT; ++i) {
+            DrawTextureRec(layerTex[i].texture,
+                (Rectangle){0.0f, 0.0f, (float)layerTex[i].texture.width, (float)-layerTex[i].texture.height},
+                (Vector2){0, 0}, WHITE);
+            // Particles fly over the board but under the banners and menus
+            if (i == LAYER_BOARD && animating) {
+                EndBlendMode();
+                BeginPremultipliedBlend();
+                BeginMode2D(renderCamera);
+                DrawParticles();
+                EndMode2D();
+                EndBlendMode();
+                BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+            }
+        }
+        EndBlendMode();
+        EndTextureMode();
+        particlesDrawn = animating;
+    }
+ 
+    // Draw the scaled texture to screen
+    BeginDrawing();
+    ClearBackground(BLACK);
+    DrawTexturePro(targetRenderTex.texture, 
+        (Rectangle){0.0f, 0.0f, (float)targetRenderTex.texture.width, (float)-targetRenderTex.texture.height},
+        (Rectangle){(GetScreenWidth() - (gameScreenWidth * scale)) * 0.5f, 
+                   (GetScreenHeight() - (gameScreenHeight * scale)) * 0.5f,
+                   gameScreenWidth * scale, gameScreenHeight * scale},
         (Vector2){0, 0}, 0.0f, WHITE);
-    
-    DrawGrid();
-    
-    // Draw game state message
+    EndDrawing();
+}
+
+uint64_t Game::LayerKey(Layer layer) const
+{
+    KeyHash key;
+    switch (layer) {
+        case LAYER_BACKGROUND:
+            key << backgroundTexture.id;
+            break;
+        case LAYER_BOARD:
+            key << board.Version() << board.Generation() << currentGridSize << cellSize << gridOffset << gameOver
+                << showHints << hintsKey << hintGuess << showHeatmap << heatmapTexVersion << heatmapTexSize
+                << ghostActive << ghostBoard.Version() << ghostBoard.Generation();
+            break;
+        case LAYER_HUD:
+            key << remainingMines << TimerText() << currentGridSize << cellSize << gridOffset << gameOver << gameWon
+                << ghostActive << ghostBoard.RemainingCells() << speedrun.Splits().size();
+            break;
+        case LAYER_MENUS:
+            key << isFileMenuOpen << isOptionsMenuOpen << isHelpMenuOpen << speedrunMode << assistMode << showHints
+                << adaptiveMode << showHeatmap << showWelcomePopup << showHelpPopup << showCustomGamePopup
+                << showSavePopup << showLoadPopup;
+            key.Add(customGridSizeInput, customGridSizeInputLength).Add(filenameInput, filenameInputLength);
+            key << customGridSizeInputLength << filenameInputLength;
+            break;
+        default:
+            break;
+    }
+    return key.Value();
+}
+
+void Game::PaintLayer(Layer layer)
+{
+    BeginTextureMode(layerTex[layer]);
+    ClearBackground(layer == LAYER_BACKGROUND ? RAYWHITE : BLANK);
+
+    BeginPremultipliedBlend();
+    BeginMode2D(renderCamera);  // Everything is drawn in game screen coordinates
+    switch (layer) {
+        case LAYER_BACKGROUND:
+            DrawTexturePro(backgroundTexture,
+                (Rectangle){0, 0, (float)backgroundTexture.width, (float)backgroundTexture.height},
+                (Rectangle){0, 0, (float)gameScreenWidth, (float)gameScreenHeight},
+                (Vector2){0, 0}, 0.0f, WHITE);
+            break;
+        case LAYER_BOARD:
+            DrawGrid();
+            break;
+        case LAYER_HUD:
+            DrawBanner();
+            DrawUI();
+            break;
+        case LAYER_MENUS:
+            DrawPopups();
+            DrawMenuBar();
+            break;
+        default:
+            break;
+    }
+    EndMode2D();
+    EndBlendMode();
+    EndTextureMode();
+}
+
+void Game::ResizeRenderTargets()
+{
+    int width = MAX(1, (int)(gameScreenWidth * resolution.Scale() + 0.5f));
+    int height = MAX(1, (int)(gameScreenHeight * resolution.Scale() + 0.5f));
+    if (targetRenderTex.id != 0) {
+        UnloadRenderTexture(targetRenderTex);
+    }
+    targetRenderTex = LoadRenderTexture(width, height);
+    SetTextureFilter(targetRenderTex.texture, TEXTURE_FILTER_BILINEAR); // Texture scale filter to use
+    for (int i = 0; i < LAYER_COUNT; ++i) {
+        if (layerTex[i].id != 0) {
+            UnloadRenderTexture(layerTex[i]);
+        }
+        layerTex[i] = LoadRenderTexture(width, height);
+        InvalidateLayer((Layer)i);
+    }
+    renderCamera = Camera2D{};
+    renderCamera.zoom = (float)width / gameScreenWidth;
+}
+
+void Game::DrawParticles() const
+{
+    // Every particle is a quad from the one atlas texture, so they all go out in one batch.
+    // Sparks are upright; confetti is a spinning strip half as tall as it is wide.
+    rlSetTexture(particleAtlas.id);
+    rlBegin(RL_QUADS);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    const float* x = particles.X();
+    const float* y = particles.Y();
+    const float* size = particles.Size();
+    const float* angle = particles.Angle();
+    for (int i = 0; i < particles.Count(); ++i) {
+        uint32_t color = particles.Color(i);
+        rlColor4ub(color & 0xff, (color >> 8) & 0xff, (color >> 16) & 0xff,
+                   (unsigned char)((color >> 24) * particles.Fade(i)));
+        float half = size[i] * 0.5f;
+        float ux = half;    // Half the quad along its width
+        float uy = 0.0f;
+        float vx = 0.0f;    // And along its height
+        float vy = half;
+        float u0 = 0.0f;
+        if (particles.Kind(i) == ParticleKind::CONFETTI) {
+            float c = cosf(angle[i]);
+            float s = sinf(angle[i]);
+            ux = c * half;
+            uy = s * half;
+            vx = -s * half * 0.5f;
+            vy = c * half * 0.5f;
+            u0 = 0.5f;
+        }
+        rlTexCoord2f(u0, 0.0f);
+        rlVertex2f(x[i] - ux - vx, y[i] - uy - vy);
+        rlTexCoord2f(u0, 1.0f);
+        rlVertex2f(x[i] - ux + vx, y[i] - uy + vy);
+        rlTexCoord2f(u0 + 0.5f, 1.0f);
+        rlVertex2f(x[i] + ux + vx, y[i] + uy + vy);
+        rlTexCoord2f(u0 + 0.5f, 0.0f);
+        rlVertex2f(x[i] + ux - vx, y[i] + uy - vy);
+    }
+    rlEnd();
+    rlSetTexture(0);
+}
+
+void Game::ExplodeMines(int row, int col)
+{
+    // The pool is shared out between the mines on show, so a board-wide loss on a big board
+    // gets fewer sparks per mine rather than more work per frame
+    particles.Clear();
+    particleGravity = SPARK_GRAVITY;
+    particleDrag = SPARK_DRAG;
+    int mines = 0;
+    board.ForEachCell([&](int, int, const Cell& cell) { mines += cell.hasMine && cell.state == CellState::REVEALED; });
+    int perMine = MIN(MAX_SPARKS_PER_MINE, MAX(1, (ParticlePool::CAPACITY - HIT_SPARKS) / MAX(mines, 1)));
+    float speed = MAX(cellSize * 5.0f, 120.0f);
+    float size = MAX(cellSize * 0.35f, 4.0f);
+    int paletteSize = sizeof(FIRE_COLORS) / sizeof(FIRE_COLORS[0]);
+    if (board.IsValidCell(row, col)) {
+        particles.EmitBurst(gridOffset.x + (col + 0.5f) * cellSize, gridOffset.y + (row + 0.5f) * cellSize,
+                            HIT_SPARKS, speed * 2.0f, size * 1.5f, FIRE_COLORS, paletteSize);
+    }
+    board.ForEachCell([&](int r, int c, const Cell& cell) {
+        if (cell.hasMine && cell.state == CellState::REVEALED && (r != row || c != col)) {
+            particles.EmitBurst(gridOffset.x + (c + 0.5f) * cellSize, gridOffset.y + (r + 0.5f) * cellSize,
+                                perMine, speed, size, FIRE_COLORS, paletteSize);
+        }
+    });
+}
+
+void Game::ThrowConfetti()
+{
+    // Thrown up from the bottom edge of the grid, fast enough to reach about its top
+    particles.Clear();
+    particleGravity = CONFETTI_GRAVITY;
+    particleDrag = CONFETTI_DRAG;
+    float gridWidth = board.Cols() * cellSize;
+    float gridHeight = board.Rows() * cellSize;
+    particles.EmitConfetti(gridOffset.x, gridWidth, gridOffset.y + gridHeight, CONFETTI_PIECES,
+                           gridHeight * 1.5f + 300.0f, 12.0f, CONFETTI_COLORS,
+                           sizeof(CONFETTI_COLORS) / sizeof(CONFETTI_COLORS[0]));
+}
+
+void Game::DrawBanner()
+{
     if (gameWon) {
         const char* text;
         int maxSize = isMobile ? MOBILE_MAX_GRID_SIZE : DESKTOP_MAX_GRID_SIZE;
@@ -561,6 +898,10 @@ void Game::Draw(float dt)
         DrawRectangleRounded((Rectangle){(float)rectX, (float)rectY, (float)rectWidth, (float)rectHeight}, 0.3f, 8, BLACK);
         // Draw text
         DrawText(text, (gameScreenWidth - textWidth) / 2, gameScreenHeight / 2 - fontSize / 2, fontSize, WHITE);
+
+        if (speedrunMode && !speedrun.Splits().empty()) {
+            DrawSplits(rectY + rectHeight + 10);
+        }
     }
     else if (gameOver && !gameWon) {
         const char* text = isMobile ? "You lost! Tap to try again" : "You lost! Click to try again";
@@ -576,25 +917,34 @@ void Game::Draw(float dt)
         DrawRectangleRounded((Rectangle){(float)rectX, (float)rectY, (float)rectWidth, (float)rectHeight}, 0.3f, 8, BLACK);
         // Draw text
         DrawText(text, (gameScreenWidth - textWidth) / 2, gameScreenHeight / 2 - fontSize / 2, fontSize, WHITE);
-        
-        // Update timer for text fade effect
-        gameOverTextTimer += dt;
     }
+}
 
-    DrawUI();
-    
-    EndTextureMode();
- 
-    // Draw the scaled texture to screen
-    BeginDrawing();
-    ClearBackground(BLACK);
-    DrawTexturePro(targetRenderTex.texture, 
-        (Rectangle){0.0f, 0.0f, (float)targetRenderTex.texture.width, (float)-targetRenderTex.texture.height},
-        (Rectangle){(GetScreenWidth() - (gameScreenWidth * scale)) * 0.5f, 
-                   (GetScreenHeight() - (gameScreenHeight * scale)) * 0.5f,
-                   gameScreenWidth * scale, gameScreenHeight * scale},
-        (Vector2){0, 0}, 0.0f, WHITE);
-    EndDrawing();
+void Game::DrawSplits(int top)
+{
+    // The latest splits of the run, newest last: size, level time and run time at the win
+    const std::vector<SpeedrunTimer::Split>& splits = speedrun.Splits();
+    const int fontSize = 20;
+    const int lineHeight = 24;
+    const int padding = 10;
+    size_t first = splits.size() > (size_t)SHOWN_SPLITS ? splits.size() - SHOWN_SPLITS : 0;
+
+    std::vector<std::string> lines;
+    int width = 0;
+    for (size_t i = first; i < splits.size(); ++i) {
+        std::string size = std::to_string(splits[i].gridSize);
+        lines.push_back(size + "x" + size + "   " + SpeedrunTimer::FormatTime(splits[i].levelNs) +
+                        "   Run " + SpeedrunTimer::FormatTime(splits[i].runNs));
+        width = MAX(width, MeasureText(lines.back().c_str(), fontSize));
+    }
+    int rectWidth = width + padding * 2;
+    int rectHeight = (int)lines.size() * lineHeight + padding * 2 - (lineHeight - fontSize);
+    int rectX = (gameScreenWidth - rectWidth) / 2;
+    DrawRectangleRounded((Rectangle){(float)rectX, (float)top, (float)rectWidth, (float)rectHeight}, 0.2f, 8, Fade(BLACK, 0.8f));
+    for (size_t i = 0; i < lines.size(); ++i) {
+        bool latest = i + 1 == lines.size();
+        DrawText(lines[i].c_str(), rectX + padding, top + padding + (int)i * lineHeight, fontSize, latest ? GOLD : WHITE);
+    }
 }
 
 void Game::DrawMenuBar()
@@ -684,14 +1034,59 @@ void Game::DrawMenuBar()
     if (isOptionsMenuOpen)
     {
         const char* toggleMusicText = "Toggle Music";
+        const char* raceGhostText = "Race Ghost";
+        const char* speedrunText = speedrunMode ? "Speedrun: On" : "Speedrun: Off";
+        const char* assistText = assistMode ? "Assist: On" : "Assist: Off";
+        const char* hintsText = showHints ? "Hints: On" : "Hints: Off";
+        const char* adaptiveText = adaptiveMode ? "Adaptive: On" : "Adaptive: Off";
+        const char* heatmapText = showHeatmap ? "Heatmap: On" : "Heatmap: Off";
         int toggleMusicTextWidth = MeasureText(toggleMusicText, 30);  // Increased font size
-        float menuWidth = (float)(toggleMusicTextWidth + 30);
+        int raceGhostTextWidth = MeasureText(raceGhostText, 30);
+        int speedrunTextWidth = MeasureText("Speedrun: Off", 30);
+        int adaptiveTextWidth = MeasureText("Adaptive: Off", 30);
+        float menuWidth = (float)(std::max({toggleMusicTextWidth, raceGhostTextWidth, speedrunTextWidth, adaptiveTextWidth}) + 30);
 
         // Draw Toggle Music option
         toggleMusicOptionRect = {optionsMenuRect.x, optionsMenuRect.y + optionsMenuRect.height,
                                menuWidth, 35};  // Increased height from 25 to 35
         DrawRectangleRec(toggleMusicOptionRect, BLACK);
         DrawText(toggleMusicText, toggleMusicOptionRect.x + 10, toggleMusicOptionRect.y + 2, 30, WHITE);  // Increased font size
+
+        // Draw Race Ghost option
+        raceGhostOptionRect = {optionsMenuRect.x, toggleMusicOptionRect.y + toggleMusicOptionRect.height,
+                               menuWidth, 35};
+        DrawRectangleRec(raceGhostOptionRect, BLACK);
+        DrawText(raceGhostText, raceGhostOptionRect.x + 10, raceGhostOptionRect.y + 2, 30, WHITE);
+
+        // Draw Speedrun option
+        speedrunOptionRect = {optionsMenuRect.x, raceGhostOptionRect.y + raceGhostOptionRect.height,
+                              menuWidth, 35};
+        DrawRectangleRec(speedrunOptionRect, BLACK);
+        DrawText(speedrunText, speedrunOptionRect.x + 10, speedrunOptionRect.y + 2, 30, WHITE);
+
+        // Draw Assist option
+        assistOptionRect = {optionsMenuRect.x, speedrunOptionRect.y + speedrunOptionRect.height,
+                            menuWidth, 35};
+        DrawRectangleRec(assistOptionRect, BLACK);
+        DrawText(assistText, assistOptionRect.x + 10, assistOptionRect.y + 2, 30, WHITE);
+
+        // Draw Hints option
+        hintsOptionRect = {optionsMenuRect.x, assistOptionRect.y + assistOptionRect.height,
+                           menuWidth, 35};
+        DrawRectangleRec(hintsOptionRect, BLACK);
+        DrawText(hintsText, hintsOptionRect.x + 10, hintsOptionRect.y + 2, 30, WHITE);
+
+        // Draw Adaptive option
+        adaptiveOptionRect = {optionsMenuRect.x, hintsOptionRect.y + hintsOptionRect.height,
+                              menuWidth, 35};
+        DrawRectangleRec(adaptiveOptionRect, BLACK);
+        DrawText(adaptiveText, adaptiveOptionRect.x + 10, adaptiveOptionRect.y + 2, 30, WHITE);
+
+        // Draw Heatmap option
+        heatmapOptionRect = {optionsMenuRect.x, adaptiveOptionRect.y + adaptiveOptionRect.height,
+                             menuWidth, 35};
+        DrawRectangleRec(heatmapOptionRect, BLACK);
+        DrawText(heatmapText, heatmapOptionRect.x + 10, heatmapOptionRect.y + 2, 30, WHITE);
     }
 
     // Draw Help menu
@@ -887,6 +1282,46 @@ bool Game::HandleMenuInput()
                 isOptionsMenuOpen = false;
                 return true;
             }
+            else if (CheckCollisionPointRec({gameX, gameY}, raceGhostOptionRect))
+            {
+                // Start over on the ghost's board; nothing happens until a game has been won
+                StartGhostRace();
+                isOptionsMenuOpen = false;
+                return true;
+            }
+            else if (CheckCollisionPointRec({gameX, gameY}, speedrunOptionRect))
+            {
+                ToggleSpeedrunMode();
+                isOptionsMenuOpen = false;
+                return true;
+            }
+            else if (CheckCollisionPointRec({gameX, gameY}, assistOptionRect))
+            {
+                assistMode = !assistMode;
+                isOptionsMenuOpen = false;
+                return true;
+            }
+            else if (CheckCollisionPointRec({gameX, gameY}, hintsOptionRect))
+            {
+                showHints = !showHints;
+                hintsKey = STALE_HINTS;  // Analyze on the next frame
+                isOptionsMenuOpen = false;
+                return true;
+            }
+            else if (CheckCollisionPointRec({gameX, gameY}, adaptiveOptionRect))
+            {
+                // Takes effect from the next board
+                adaptiveMode = !adaptiveMode;
+                isOptionsMenuOpen = false;
+                return true;
+            }
+            else if (CheckCollisionPointRec({gameX, gameY}, heatmapOptionRect))
+            {
+                showHeatmap = !showHeatmap;
+                heatmapTexSize = 0;  // Rebuild the texture on the next frame
+                isOptionsMenuOpen = false;
+                return true;
+            }
             else
             {
                 isOptionsMenuOpen = false;
@@ -1074,23 +1509,33 @@ void Game::Randomize() {
             currentGridSize++;
         }
         // Don't reset grid size on loss - keep the same size
+
+        // A speedrun goes through the whole progression, so anything but a win starts the run over
+        if (speedrunMode && (!gameWon || speedrun.IsFinished())) {
+            currentGridSize = isMobile ? MOBILE_INITIAL_GRID_SIZE : DESKTOP_INITIAL_GRID_SIZE;
+            speedrun.Reset();
+        }
         
-        // Clear the grid before initializing
-        grid.clear();
-        
-        InitializeGrid();
-        PlaceMines();
-        CalculateAdjacentMines();
-        remainingCells = currentGridSize * currentGridSize - CalculateMineCount();
-        gameOver = false;
-        gameWon = false;
-        gameOverTextTimer = 0.0f;  // Reset game over text timer
-        gameTime = 0.0f;  // Reset timer
-        waitingForNextLevel = false;  // Reset waiting state
-        waitingForGameOver = false;  // Reset game over waiting state
-        
-        // Update scaling to adjust view for new grid size
-        UpdateScaling();
+        StopGhost();
+        std::random_device rd;
+        unsigned int seed = rd();
+        int mineCount = CalculateMineCount();
+
+        // Adaptive difficulty picks among seeds for this size; speedruns keep plain random
+        // boards so runs stay comparable
+        if (adaptiveMode && !speedrunMode) {
+            if (gameOver) {
+                difficultyLevel = gameWon ? MIN(difficultyLevel + 1, MAX_DIFFICULTY_LEVEL) : MAX(difficultyLevel - 1, 0);
+            }
+            GeneratedBoard generated = NextAdaptiveBoard(mineCount, seed);
+            seed = generated.seed;
+#ifdef DEBUG
+            std::cout << "Adaptive board: level " << difficultyLevel << ", 3BV " << generated.metrics.bbbv
+                      << ", guesses " << generated.metrics.guesses << ", depth " << generated.metrics.maxDepth
+                      << (generated.matched ? "" : " (closest match)") << std::endl;
+#endif
+        }
+        StartNewBoard(seed, mineCount);
 #ifdef DEBUG
         std::cout << "Game randomized successfully" << std::endl;
         
@@ -1100,7 +1545,7 @@ void Game::Randomize() {
             std::cout << "Mine positions:" << std::endl;
             for (int row = 0; row < currentGridSize; ++row) {
                 for (int col = 0; col < currentGridSize; ++col) {
-                    std::cout << (grid[row][col].hasMine ? "1" : "0") << " ";
+                    std::cout << (board.At(row, col).hasMine ? "1" : "0") << " ";
                 }
                 std::cout << std::endl;
             }
@@ -1117,86 +1562,91 @@ void Game::Randomize() {
     }
 }
 
-void Game::InitializeGrid() {
+void Game::StartNewBoard(unsigned int seed, int mineCount) {
     try {
 #ifdef DEBUG
-        std::cout << "Initializing grid with size: " << currentGridSize << std::endl;
+        std::cout << "Generating board with seed " << seed << std::endl;
 #endif
-        grid.resize(currentGridSize, std::vector<Cell>(currentGridSize));
-        for (int row = 0; row < currentGridSize; ++row) {
-            for (int col = 0; col < currentGridSize; ++col) {
-                grid[row][col] = { false, CellState::HIDDEN, 0 };
-            }
+        boardSeed = seed;
+        board.Generate(currentGridSize, currentGridSize, mineCount, seed);
+        boardValue = BoardGenerator::Compute3BV(board);
+        remainingMines = mineCount;
+        replayRecorder.Begin({ currentGridSize, currentGridSize, mineCount, seed });
+
+        gameOver = false;
+        gameWon = false;
+        gameOverTextTimer = 0.0f;  // Reset game over text timer
+        gameTime = 0.0f;  // Reset timer
+        particles.Clear();
+        waitingForNextLevel = false;  // Reset waiting state
+        waitingForGameOver = false;  // Reset game over waiting state
+        speedrun.ResetLevel();
+
+        // Save the last game's clicks; the web build never gets to the destructor
+        if (heatmap.Version() != heatmapSavedVersion) {
+            heatmap.Save(HEATMAP_FILE);
+            heatmapSavedVersion = heatmap.Version();
         }
-#ifdef DEBUG
-        std::cout << "Grid initialized successfully" << std::endl;
-#endif
+
+        // Update scaling to adjust view for new grid size
+        UpdateScaling();
     } catch (const std::exception& e) {
 #ifdef DEBUG
-        std::cerr << "Exception in InitializeGrid: " << e.what() << std::endl;
-#endif
-    } catch (...) {
-#ifdef DEBUG
-        std::cerr << "Unknown exception in InitializeGrid" << std::endl;
+        std::cerr << "Exception in StartNewBoard: " << e.what() << std::endl;
 #endif
     }
 }
 
-int Game::CalculateMineCount() const {
-    // Calculate total cells
-    int totalCells = currentGridSize * currentGridSize;
-    
-    // Use approximately 15% of cells as mines
-    // This gives us a good balance between challenge and playability
-    int mineCount = static_cast<int>(totalCells * 0.15f);
-    
-    // Ensure we have at least 1 mine
-    return MAX(1, mineCount);
+DifficultyTarget Game::AdaptiveTarget(int level) const {
+    // 3BV is capped at what the player clears in the target time at their measured speed;
+    // the level sets how much reasoning and guessing the board may need
+    DifficultyTarget target;
+    target.min3bv = 0;
+    target.max3bv = MAX(1, (int)(playerSpeed * TARGET_LEVEL_SECONDS));
+    target.minGuesses = 0;
+    target.maxGuesses = level >= MAX_DIFFICULTY_LEVEL ? 1 : 0;
+    target.minDepth = level >= 2 ? level : 0;
+    target.maxDepth = MIN(level + 1, 3);
+    return target;
 }
 
-void Game::PlaceMines() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, currentGridSize - 1);
-
-    int minesToPlace = CalculateMineCount();
-    int minesPlaced = 0;
-    while (minesPlaced < minesToPlace) {
-        int row = dis(gen);
-        int col = dis(gen);
-        
-        // Skip if this is a corner cell
-        bool isCorner = (row == 0 && col == 0) || // top-left
-                       (row == 0 && col == currentGridSize - 1) || // top-right
-                       (row == currentGridSize - 1 && col == 0) || // bottom-left
-                       (row == currentGridSize - 1 && col == currentGridSize - 1); // bottom-right
-        
-        if (!isCorner && !grid[row][col].hasMine) {
-            grid[row][col].hasMine = true;
-            minesPlaced++;
-        }
+void Game::PrepareAdaptiveBoard() {
+    if (!adaptiveMode || speedrunMode || generationTask.Started()) {
+        return;
     }
-    remainingMines = minesToPlace;
+
+    // The same size and level Randomize() will move on to from this result
+    int maxSize = isMobile ? MOBILE_MAX_GRID_SIZE : DESKTOP_MAX_GRID_SIZE;
+    int level = gameWon ? MIN(difficultyLevel + 1, MAX_DIFFICULTY_LEVEL) : MAX(difficultyLevel - 1, 0);
+    preparedSize = gameWon && currentGridSize < maxSize ? currentGridSize + 1 : currentGridSize;
+    preparedMineCount = Board::DefaultMineCount(preparedSize, preparedSize);
+    preparedTarget = AdaptiveTarget(level);
+
+    std::random_device rd;
+    unsigned int seed = rd();
+    int size = preparedSize;
+    int mineCount = preparedMineCount;
+    DifficultyTarget target = preparedTarget;
+    generationTask.Start([this, size, mineCount, target, seed]() {
+        return generator.Generate(size, size, mineCount, target, seed, GENERATION_BUDGET);
+    });
 }
 
-void Game::CalculateAdjacentMines() {
-    for (int row = 0; row < currentGridSize; ++row) {
-        for (int col = 0; col < currentGridSize; ++col) {
-            if (!grid[row][col].hasMine) {
-                int count = 0;
-                for (int dr = -1; dr <= 1; ++dr) {
-                    for (int dc = -1; dc <= 1; ++dc) {
-                        int newRow = row + dr;
-                        int newCol = col + dc;
-                        if (IsValidCell(newRow, newCol) && grid[newRow][newCol].hasMine) {
-                            count++;
-                        }
-                    }
-                }
-                grid[row][col].adjacentMines = count;
-            }
+GeneratedBoard Game::NextAdaptiveBoard(int mineCount, unsigned int seed) {
+    // Normally the board was generated while the last game's result was on screen; the
+    // generator is only run here, holding up the frame, for a size or target nobody expected
+    DifficultyTarget target = AdaptiveTarget(difficultyLevel);
+    if (generationTask.Started()) {
+        GeneratedBoard prepared = generationTask.Take();
+        if (preparedSize == currentGridSize && preparedMineCount == mineCount && SameTarget(preparedTarget, target)) {
+            return prepared;
         }
     }
+    return generator.Generate(currentGridSize, currentGridSize, mineCount, target, seed, GENERATION_BUDGET);
+}
+
+int Game::CalculateMineCount() const {
+    return Board::DefaultMineCount(currentGridSize, currentGridSize);
 }
 
 void Game::RevealCell(int row, int col) {
@@ -1204,14 +1654,20 @@ void Game::RevealCell(int row, int col) {
 #ifdef DEBUG
         std::cout << "Revealing cell at row=" << row << ", col=" << col << std::endl;
 #endif
-        if (!IsValidCell(row, col) || grid[row][col].state != CellState::HIDDEN) {
+        // Commit the speculated plan if it was computed for this cell on the current board
+        assistSeeds.clear();
+        RevealOutcome outcome = speculation.IsReadyFor(board, row, col, false) ?
+            board.CommitPlan(speculation.Plan(), &assistSeeds) : board.RevealCell(row, col, &assistSeeds);
+        if (outcome == RevealOutcome::NONE) {
             return;
         }
+        replayRecorder.Record(MoveType::REVEAL, row, col, gameTime);
+        RecordClick(MoveType::REVEAL, row, col);
+        if (speedrunMode) {
+            speedrun.RecordMove(inputTimestampNs);
+        }
 
-        grid[row][col].state = CellState::REVEALED;
-        remainingCells--;
-
-        if (grid[row][col].hasMine) {
+        if (outcome == RevealOutcome::HIT_MINE) {
 #ifdef DEBUG
             std::cout << "Mine hit at row=" << row << ", col=" << col << std::endl;
 #endif
@@ -1219,26 +1675,16 @@ void Game::RevealCell(int row, int col) {
             gameOver = true;
             gameWon = false;
             waitingForGameOver = true;  // Set flag to wait for player input
-            RevealAllMines();
+            board.RevealAllMines();
+            ExplodeMines(row, col);
             return;
         }
 
         PlaySound(actionSound);  // Play action sound for successful reveal
-
-        if (grid[row][col].adjacentMines == 0) {
-            for (int dr = -1; dr <= 1; ++dr) {
-                for (int dc = -1; dc <= 1; ++dc) {
-                    int newRow = row + dr;
-                    int newCol = col + dc;
-                    if (IsValidCell(newRow, newCol) && 
-                        grid[newRow][newCol].state == CellState::HIDDEN) {
-                        RevealCell(newRow, newCol);
-                    }
-                }
-            }
+        RunAssist();
+        if (!gameOver) {
+            CheckWinCondition();
         }
-
-        CheckWinCondition();
     } catch (const std::exception& e) {
 #ifdef DEBUG
         std::cerr << "Exception in RevealCell: " << e.what() << " at row=" << row << ", col=" << col << std::endl;
@@ -1246,61 +1692,152 @@ void Game::RevealCell(int row, int col) {
     }
 }
 
-void Game::RevealAllMines() {
-    try {
-#ifdef DEBUG
-        std::cout << "Starting RevealAllMines with grid size: " << currentGridSize << std::endl;
-        std::cout << "Grid dimensions: rows=" << grid.size() << ", cols=" << (grid.empty() ? 0 : grid[0].size()) << std::endl;
-#endif
-        
-        int minesRevealed = 0;
-        for (int row = 0; row < currentGridSize; ++row) {
-            for (int col = 0; col < currentGridSize; ++col) {
-                try {
-                    if (grid[row][col].hasMine) {
-#ifdef DEBUG
-                        std::cout << "Revealing mine at row=" << row << ", col=" << col 
-                                 << ", current state=" << static_cast<int>(grid[row][col].state) << std::endl;
-#endif
-                        grid[row][col].state = CellState::REVEALED;
-                        minesRevealed++;
-                    }
-                } catch (const std::exception& e) {
-#ifdef DEBUG
-                    std::cerr << "Error processing cell at row=" << row << ", col=" << col 
-                              << ": " << e.what() << std::endl;
-#endif
-                } catch (...) {
+void Game::UpdateSpeculation(int row, int col) {
+    if (!board.IsValidCell(row, col)) {
+        return;
+    }
+
+    // Hidden cells get a reveal plan, numbers a chord plan
+    const Cell& cell = board.At(row, col);
+    bool chord = cell.state == CellState::REVEALED;
+    if (cell.state == CellState::FLAGGED || (chord && cell.flaggedNeighbors != cell.adjacentMines)) {
+        return;  // Nothing to plan; an ineligible chord is rejected in O(1) anyway
+    }
+    if (!speculation.IsTarget(row, col, chord)) {
+        speculation.Begin(board, row, col, chord);
+    }
+
+    // Spend a slice of the frame on it; a huge cascade simply carries on next frame
+    double deadline = GetTime() + SPECULATION_BUDGET;
+    while (!speculation.Step(board, SPECULATION_CHUNK) && GetTime() < deadline) {
+    }
+}
+
+bool Game::ToggleFlag(int row, int col) {
+    if (!board.ToggleFlag(row, col)) {
+        return false;
+    }
+    replayRecorder.Record(MoveType::FLAG, row, col, gameTime);
+    RecordClick(MoveType::FLAG, row, col);
+    if (speedrunMode) {
+        speedrun.RecordMove(inputTimestampNs);
+    }
+
+    // A new flag can complete the numbers around it; removing one must not be undone by the assist
+    if (board.At(row, col).state == CellState::FLAGGED) {
+        assistSeeds.assign(1, board.Index(row, col));
+        RunAssist();
+    }
+    if (!gameOver) {
+        CheckWinCondition();
+    }
+    return true;
+}
+
+void Game::RunAssist() {
+    if (!assistMode || assistSeeds.empty()) {
+        return;
+    }
+
+    // Runs to a fixpoint right away, however many reveals one move unlocks
+    RevealOutcome outcome = assist.Run(board, assistSeeds, assistMoves);
+    for (const AssistMove& move : assistMoves) {
+        replayRecorder.Record(move.type, move.row, move.col, gameTime);
+    }
 #ifdef DEBUG
-                    std::cerr << "Unknown error processing cell at row=" << row << ", col=" << col << std::endl;
+    if (!assistMoves.empty()) {
+        std::cout << "Assist made " << assistMoves.size() << " moves" << std::endl;
+    }
 #endif
-                }
+
+    if (outcome == RevealOutcome::HIT_MINE) {
+        // Only possible when one of the player's flags was wrong
+        PlaySound(hitSound);
+        gameOver = true;
+        gameWon = false;
+        waitingForGameOver = true;
+        ExplodeMines(-1, -1);
+    }
+}
+
+void Game::CheckWinCondition() {
+    if (board.RemainingCells() == 0) {
+        gameOver = true;
+        gameWon = true;
+        waitingForNextLevel = true;  // Set flag to wait for player input
+        ThrowConfetti();
+
+        // The winning game becomes the ghost to race against
+        replayRecorder.SaveToFile(GHOST_REPLAY_FILE);
+
+        // Running estimate of the player's 3BV/s, used to size adaptive boards
+        float speed = boardValue / MAX(gameTime, 1.0f);
+        playerSpeed += PLAYER_SPEED_SMOOTHING * (speed - playerSpeed);
+
+        if (speedrunMode) {
+            int maxSize = isMobile ? MOBILE_MAX_GRID_SIZE : DESKTOP_MAX_GRID_SIZE;
+            speedrun.FinishLevel(currentGridSize, inputTimestampNs, currentGridSize == maxSize);
+            if (speedrun.IsFinished()) {
+                speedrun.SaveToFile(SPEEDRUN_FILE);
             }
-        }
 #ifdef DEBUG
-        std::cout << "RevealAllMines completed. Total mines revealed: " << minesRevealed << std::endl;
-#endif
-    } catch (const std::exception& e) {
-#ifdef DEBUG
-        std::cerr << "Exception in RevealAllMines: " << e.what() << std::endl;
-#endif
-    } catch (...) {
-#ifdef DEBUG
-        std::cerr << "Unknown exception in RevealAllMines" << std::endl;
+            const SpeedrunTimer::Split& split = speedrun.Splits().back();
+            std::cout << "Split " << split.gridSize << "x" << split.gridSize << ": "
+                      << SpeedrunTimer::FormatTime(split.levelNs) << " (run "
+                      << SpeedrunTimer::FormatTime(split.runNs) << ")" << std::endl;
 #endif
+        }
     }
 }
 
-bool Game::IsValidCell(int row, int col) const {
-    return row >= 0 && row < currentGridSize && col >= 0 && col < currentGridSize;
+void Game::RecordClick(MoveType type, int row, int col) {
+    heatmap.Record(type, row, col, board.Rows(), board.Cols());
 }
 
-void Game::CheckWinCondition() {
-    if (remainingCells == 0) {
-        gameOver = true;
-        gameWon = true;
-        waitingForNextLevel = true;  // Set flag to wait for player input
+void Game::UpdateHeatmapTexture() {
+    if (heatmapTexVersion == heatmap.Version() && heatmapTexSize == currentGridSize) {
+        return;
     }
+    heatmapTexVersion = heatmap.Version();
+    heatmapTexSize = currentGridSize;
+
+    // Small boards get a texel per cell, larger ones a texel per bin
+    int rows = board.Rows();
+    int cols = board.Cols();
+    int texRows = MIN(rows, ClickHeatmap::RESOLUTION);
+    int texCols = MIN(cols, ClickHeatmap::RESOLUTION);
+    uint32_t maxCount = 0;
+    for (int y = 0; y < texRows; ++y) {
+        for (int x = 0; x < texCols; ++x) {
+            int binRow = rows <= ClickHeatmap::RESOLUTION ? ClickHeatmap::Bin(y, rows) : y;
+            int binCol = cols <= ClickHeatmap::RESOLUTION ? ClickHeatmap::Bin(x, cols) : x;
+            maxCount = std::max(maxCount, heatmap.Total(rows, cols, binRow, binCol));
+        }
+    }
+
+    // Blue for rarely clicked cells through to red for the most clicked, untouched cells clear
+    for (int y = 0; y < texRows; ++y) {
+        for (int x = 0; x < texCols; ++x) {
+            int binRow = rows <= ClickHeatmap::RESOLUTION ? ClickHeatmap::Bin(y, rows) : y;
+            int binCol = cols <= ClickHeatmap::RESOLUTION ? ClickHeatmap::Bin(x, cols) : x;
+            uint32_t count = heatmap.Total(rows, cols, binRow, binCol);
+            Color color = BLANK;
+            if (count > 0) {
+                float heat = (float)count / maxCount;
+                color = Fade(ColorFromHSV(240.0f * (1.0f - heat), 1.0f, 1.0f), 0.25f + 0.35f * heat);
+            }
+            heatmapPixels[y * ClickHeatmap::RESOLUTION + x] = color;
+        }
+    }
+
+    // The whole grid goes up in a single upload
+    UpdateTexture(heatmapTex, heatmapPixels.data());
+}
+
+void Game::ToggleSpeedrunMode() {
+    speedrunMode = !speedrunMode;
+    speedrun.Reset();
+    ResetToInitialSize();
 }
 
 void Game::DrawGrid() const {
@@ -1308,42 +1845,77 @@ void Game::DrawGrid() const {
     DrawRectangle(gridOffset.x, gridOffset.y, 
                  currentGridSize * cellSize, currentGridSize * cellSize, BLACK);
     
-    for (int row = 0; row < currentGridSize; ++row) {
-        for (int col = 0; col < currentGridSize; ++col) {
-            DrawCell(row, col);
+    board.ForEachCell([this](int row, int col, const Cell&) { DrawCell(row, col); });
+
+    // Mark the cells the visible numbers decide: green is safe, red is a mine, yellow the best guess
+    if (showHints && !gameOver) {
+        for (int index : hints.safe) {
+            DrawRectangle(gridOffset.x + (index % board.Cols()) * cellSize, gridOffset.y + (index / board.Cols()) * cellSize,
+                          cellSize-1, cellSize-1, Fade(GREEN, 0.35f));
+        }
+        for (int index : hints.mines) {
+            DrawRectangle(gridOffset.x + (index % board.Cols()) * cellSize, gridOffset.y + (index / board.Cols()) * cellSize,
+                          cellSize-1, cellSize-1, Fade(RED, 0.35f));
+        }
+        // The guess arrives frames after the move, so skip it if it has been flagged since or
+        // is left over from a board of another size
+        if (hintGuess >= 0 && hintGuess < board.Rows() * board.Cols() && board.AtIndex(hintGuess).state == CellState::HIDDEN) {
+            DrawRectangle(gridOffset.x + (hintGuess % board.Cols()) * cellSize, gridOffset.y + (hintGuess / board.Cols()) * cellSize,
+                          cellSize-1, cellSize-1, Fade(YELLOW, 0.45f));
         }
     }
+
+    // Shade each cell by how often it's clicked on boards of this size
+    if (showHeatmap) {
+        int texCols = MIN(board.Cols(), ClickHeatmap::RESOLUTION);
+        int texRows = MIN(board.Rows(), ClickHeatmap::RESOLUTION);
+        DrawTexturePro(heatmapTex,
+            (Rectangle){0.0f, 0.0f, (float)texCols, (float)texRows},
+            (Rectangle){gridOffset.x, gridOffset.y, board.Cols() * cellSize, board.Rows() * cellSize},
+            (Vector2){0, 0}, 0.0f, WHITE);
+    }
+
+    // Draw the ghost's progress as a translucent overlay
+    if (ghostActive) {
+        DrawTexturePro(ghostOverlayTex.texture,
+            (Rectangle){0.0f, 0.0f, (float)ghostOverlayTex.texture.width, (float)-ghostOverlayTex.texture.height},
+            (Rectangle){0.0f, 0.0f, (float)gameScreenWidth, (float)gameScreenHeight},
+            (Vector2){0, 0}, 0.0f, Fade(WHITE, 0.35f));
+    }
 }
 
 void Game::DrawCell(int row, int col) const {
     // Calculate cell position
     float x = gridOffset.x + col * cellSize;
     float y = gridOffset.y + row * cellSize;
+    const Cell& cell = board.At(row, col);
     
     // Draw cell background
     Color cellColor = (Color){0, 255, 255, 255};  // Aqua blue for hidden cells
-    if (grid[row][col].state == CellState::REVEALED || grid[row][col].state == CellState::FLAGGED) {
+    if (cell.state == CellState::REVEALED || cell.state == CellState::FLAGGED) {
         cellColor = (Color){135, 206, 235, 255};  // Sky blue for revealed and flagged cells
     }
     DrawRectangle(x, y, cellSize-1, cellSize-1, cellColor);    
     
     // Draw cell content
-    if (grid[row][col].state == CellState::REVEALED) {
-        if (grid[row][col].hasMine) {
+    if (cell.state == CellState::REVEALED) {
+        if (cell.hasMine) {
             // Draw bomb texture
             Rectangle source = { 0, 0, (float)bombTexture.width, (float)bombTexture.height };
             Rectangle dest = { x, y, cellSize-2, cellSize-2};
             DrawTexturePro(bombTexture, source, dest, Vector2{0, 0}, 0, WHITE);
         }
-        else if (grid[row][col].adjacentMines > 0) {
+        else if (cell.adjacentMines > 0) {
             // Draw number texture
-            Rectangle source = { 0, 0, (float)numberTextures[grid[row][col].adjacentMines - 1].width, 
-                               (float)numberTextures[grid[row][col].adjacentMines - 1].height };
+            Rectangle source = { 0, 0, (float)numberTextures[cell.adjacentMines - 1].width, 
+                               (float)numberTextures[cell.adjacentMines - 1].height };
             Rectangle dest = { x, y, cellSize-2, cellSize-2};
-            DrawTexturePro(numberTextures[grid[row][col].adjacentMines - 1], source, dest, Vector2{0, 0}, 0, WHITE);
+            // Numbers with all their flags placed are dimmed, so the unfinished ones stand out
+            Color tint = board.IsSatisfied(row, col) ? Fade(WHITE, SATISFIED_NUMBER_ALPHA) : WHITE;
+            DrawTexturePro(numberTextures[cell.adjacentMines - 1], source, dest, Vector2{0, 0}, 0, tint);
         }
     }
-    else if (grid[row][col].state == CellState::FLAGGED) {
+    else if (cell.state == CellState::FLAGGED) {
         // Draw flag texture
         Rectangle source = { 0, 0, (float)flagTexture.width, (float)flagTexture.height };
         Rectangle dest = { x, y, cellSize-2, cellSize-2};
@@ -1395,38 +1967,6 @@ void Game::UnloadTextures() {
     UnloadTexture(backgroundTexture);
 }
 
-void Game::RevealNeighboringMines(int row, int col)
-{
-#ifdef DEBUG
-    std::cout << "Revealing neighboring mines around cell (" << row << ", " << col << ")" << std::endl;
-#endif
-
-    try {
-        // Check all 8 neighboring cells
-        for (int i = -1; i <= 1; i++) {
-            for (int j = -1; j <= 1; j++) {
-                if (i == 0 && j == 0) continue; // Skip the center cell
-                
-                int newRow = row + i;
-                int newCol = col + j;
-                
-                if (IsValidCell(newRow, newCol)) {
-                    if (grid[newRow][newCol].hasMine) {
-                        grid[newRow][newCol].state = CellState::REVEALED;
-#ifdef DEBUG
-                        std::cout << "Revealed mine at (" << newRow << ", " << newCol << ")" << std::endl;
-#endif
-                    }
-                }
-            }
-        }
-    } catch (const std::exception& e) {
-#ifdef DEBUG
-        std::cout << "Error in RevealNeighboringMines: " << e.what() << std::endl;
-#endif
-    }
-}
-
 void Game::RevealAdjacentCells(int row, int col)
 {
 #ifdef DEBUG
@@ -1434,71 +1974,30 @@ void Game::RevealAdjacentCells(int row, int col)
 #endif
 
     try {
-        // Count flagged neighbors
-        int flaggedNeighbors = 0;
-        for (int i = -1; i <= 1; i++) {
-            for (int j = -1; j <= 1; j++) {
-                if (i == 0 && j == 0) continue; // Skip the center cell
-                
-                int newRow = row + i;
-                int newCol = col + j;
-                
-                if (IsValidCell(newRow, newCol) && grid[newRow][newCol].state == CellState::FLAGGED) {
-                    flaggedNeighbors++;
-                }
-            }
+        assistSeeds.clear();
+        RevealOutcome outcome = speculation.IsReadyFor(board, row, col, true) ?
+            board.CommitPlan(speculation.Plan(), &assistSeeds) : board.RevealAdjacentCells(row, col, &assistSeeds);
+        if (outcome == RevealOutcome::NONE) {
+            return;
+        }
+        replayRecorder.Record(MoveType::CHORD, row, col, gameTime);
+        RecordClick(MoveType::CHORD, row, col);
+        if (speedrunMode) {
+            speedrun.RecordMove(inputTimestampNs);
         }
 
-        // If the number of flagged neighbors matches the adjacent mines count
-        if (flaggedNeighbors == grid[row][col].adjacentMines) {
-            // Check if any flagged cell is not a mine (mistake)
-            bool mistakeMade = false;
-            for (int i = -1; i <= 1; i++) {
-                for (int j = -1; j <= 1; j++) {
-                    if (i == 0 && j == 0) continue;
-                    
-                    int newRow = row + i;
-                    int newCol = col + j;
-                    
-                    if (IsValidCell(newRow, newCol) && 
-                        grid[newRow][newCol].state == CellState::FLAGGED && 
-                        !grid[newRow][newCol].hasMine) {
-                        mistakeMade = true;
-                        break;
-                    }
-                }
-                if (mistakeMade) break;
-            }
-
-            if (mistakeMade) {
-                // Reveal only the neighboring mines to show the mistake
-                RevealNeighboringMines(row, col);
-                gameOver = true;
-                waitingForGameOver = true;  // Set flag to wait for player input
-                return;
-            }
+        if (outcome == RevealOutcome::HIT_MINE) {
+            // The board only reveals the neighboring mines to show the mistake
+            gameOver = true;
+            waitingForGameOver = true;  // Set flag to wait for player input
+            ExplodeMines(row, col);
+            return;
+        }
 
-            // Reveal all non-flagged adjacent cells
-            for (int i = -1; i <= 1; i++) {
-                for (int j = -1; j <= 1; j++) {
-                    if (i == 0 && j == 0) continue;
-                    
-                    int newRow = row + i;
-                    int newCol = col + j;
-                    
-                    if (IsValidCell(newRow, newCol) && 
-                        grid[newRow][newCol].state != CellState::FLAGGED) {
-                        if (grid[newRow][newCol].hasMine) {
-                            // Hit a mine - reveal only neighboring mines
-                            RevealNeighboringMines(newRow, newCol);
-                            gameOver = true;
-                            waitingForGameOver = true;  // Set flag to wait for player input
-                            return;
-                        }
-                        RevealCell(newRow, newCol);
-                    }
-                }
-            }
+        PlaySound(actionSound);
+        RunAssist();
+        if (!gameOver) {
+            CheckWinCondition();
         }
     } catch (const std::exception& e) {
 #ifdef DEBUG
@@ -1528,23 +2027,21 @@ void Game::InitializeDebugGrid() {
 
         // Set grid size to match debug pattern
         currentGridSize = 5;
-        grid.clear();
-        grid.resize(currentGridSize, std::vector<Cell>(currentGridSize));
+        board.Reset(currentGridSize, currentGridSize);
 
         // Initialize grid with debug pattern
         for (int row = 0; row < currentGridSize; ++row) {
             for (int col = 0; col < currentGridSize; ++col) {
-                grid[row][col] = { 
-                    debugMines[row][col] == 1,  // hasMine
-                    CellState::HIDDEN,          // state
-                    0                           // adjacentMines (will be calculated)
-                };
+                board.At(row, col).hasMine = debugMines[row][col] == 1;
             }
         }
 
         // Calculate adjacent mines
-        CalculateAdjacentMines();
-        remainingCells = currentGridSize * currentGridSize - CalculateMineCount();
+        board.CalculateAdjacentMines();
+        board.RebuildIndexes();
+        boardValue = BoardGenerator::Compute3BV(board);
+        board.SetRemainingCells(currentGridSize * currentGridSize - CalculateMineCount());
+        replayRecorder.Stop();  // The debug pattern has no seed
         gameOver = false;
         gameWon = false;
         gameTime = 0.0f;
@@ -1556,7 +2053,7 @@ void Game::InitializeDebugGrid() {
         std::cout << "Mine positions:" << std::endl;
         for (int row = 0; row < currentGridSize; ++row) {
             for (int col = 0; col < currentGridSize; ++col) {
-                std::cout << (grid[row][col].hasMine ? "1" : "0") << " ";
+                std::cout << (board.At(row, col).hasMine ? "1" : "0") << " ";
             }
             std::cout << std::endl;
         }
@@ -1581,16 +2078,19 @@ bool Game::SaveGame(const std::string& filename) {
         // Save grid size
         file.write(reinterpret_cast<const char*>(&currentGridSize), sizeof(currentGridSize));
         
-        // Save grid state
+        // Save grid state; state and count are written as ints, whatever size the cell fields are
         for (int row = 0; row < currentGridSize; ++row) {
             for (int col = 0; col < currentGridSize; ++col) {
-                file.write(reinterpret_cast<const char*>(&grid[row][col].hasMine), sizeof(bool));
-                file.write(reinterpret_cast<const char*>(&grid[row][col].state), sizeof(CellState));
-                file.write(reinterpret_cast<const char*>(&grid[row][col].adjacentMines), sizeof(int));
+                int state = (int)board.At(row, col).state;
+                int adjacentMines = board.At(row, col).adjacentMines;
+                file.write(reinterpret_cast<const char*>(&board.At(row, col).hasMine), sizeof(bool));
+                file.write(reinterpret_cast<const char*>(&state), sizeof(int));
+                file.write(reinterpret_cast<const char*>(&adjacentMines), sizeof(int));
             }
         }
         
         // Save game state
+        int remainingCells = board.RemainingCells();
         file.write(reinterpret_cast<const char*>(&gameOver), sizeof(bool));
         file.write(reinterpret_cast<const char*>(&gameWon), sizeof(bool));
         file.write(reinterpret_cast<const char*>(&gameTime), sizeof(float));
@@ -1626,19 +2126,23 @@ bool Game::LoadGame(const std::string& filename) {
         
         // Resize grid
         currentGridSize = loadedGridSize;
-        grid.clear();
-        grid.resize(currentGridSize, std::vector<Cell>(currentGridSize));
+        board.Reset(currentGridSize, currentGridSize);
         
         // Load grid state
         for (int row = 0; row < currentGridSize; ++row) {
             for (int col = 0; col < currentGridSize; ++col) {
-                file.read(reinterpret_cast<char*>(&grid[row][col].hasMine), sizeof(bool));
-                file.read(reinterpret_cast<char*>(&grid[row][col].state), sizeof(CellState));
-                file.read(reinterpret_cast<char*>(&grid[row][col].adjacentMines), sizeof(int));
+                int state = 0;
+                int adjacentMines = 0;
+                file.read(reinterpret_cast<char*>(&board.At(row, col).hasMine), sizeof(bool));
+                file.read(reinterpret_cast<char*>(&state), sizeof(int));
+                file.read(reinterpret_cast<char*>(&adjacentMines), sizeof(int));
+                board.At(row, col).state = (CellState)state;
+                board.At(row, col).adjacentMines = (uint8_t)adjacentMines;
             }
         }
         
         // Load game state
+        int remainingCells = 0;
         file.read(reinterpret_cast<char*>(&gameOver), sizeof(bool));
         file.read(reinterpret_cast<char*>(&gameWon), sizeof(bool));
         file.read(reinterpret_cast<char*>(&gameTime), sizeof(float));
@@ -1646,6 +2150,13 @@ bool Game::LoadGame(const std::string& filename) {
         file.read(reinterpret_cast<char*>(&remainingMines), sizeof(int));
         
         file.close();
+        board.SetRemainingCells(remainingCells);
+        board.RebuildIndexes();
+        boardValue = BoardGenerator::Compute3BV(board);
+
+        // Saves don't store the board seed, so the loaded game can't be recorded or raced
+        replayRecorder.Stop();
+        StopGhost();
         
         // Update scaling for the loaded grid
         UpdateScaling();
@@ -1659,4 +2170,130 @@ bool Game::LoadGame(const std::string& filename) {
 #endif
         return false;
     }
-}
\ No newline at end of file
+}
+
+bool Game::StartGhostRace() {
+    try {
+        if (!ghostReplay.Open(GHOST_REPLAY_FILE)) {
+#ifdef DEBUG
+            std::cout << "No ghost replay to race against" << std::endl;
+#endif
+            return false;
+        }
+
+        // The ghost was recorded on a square board of the progression
+        const ReplayHeader& header = ghostReplay.Header();
+        if (header.rows != header.cols) {
+            ghostReplay.Close();
+            return false;
+        }
+
+        currentGridSize = header.rows;
+        StartNewBoard(header.seed, header.mineCount);
+        ghostBoard = board;
+        ghostChanged.clear();
+        ghostActive = true;
+
+        // Start from an empty overlay; cells are painted in as the ghost reveals them
+        BeginTextureMode(ghostOverlayTex);
+        ClearBackground(BLANK);
+        EndTextureMode();
+        return true;
+    } catch (const std::exception& e) {
+#ifdef DEBUG
+        std::cerr << "Exception in StartGhostRace: " << e.what() << std::endl;
+#endif
+        return false;
+    }
+}
+
+void Game::StopGhost() {
+    ghostActive = false;
+    ghostReplay.Close();
+    ghostChanged.clear();
+}
+
+void Game::UpdateHints() {
+    // Flags are only guesses to both solvers, so only reveals and new boards change the hints
+    uint64_t key = ((uint64_t)board.Generation() << 32) | (uint32_t)board.RemainingCells();
+    if (key != hintsKey) {
+        hintsKey = key;
+
+        // The solver keeps its state between moves, so only new numbers are encoded
+        if (!deduction.Analyze(board, CalculateMineCount(), hints)) {
+            hints.safe.clear();
+            hints.mines.clear();
+        }
+
+        // Nothing is safe for sure: suggest the guess with the best odds of getting further
+        hintGuess = -1;
+        guessPending = hints.safe.empty() && board.GetFrontier().Unknowns().Size() > 0;
+#ifdef DEBUG
+        std::cout << "Hints: " << hints.safe.size() << " safe, " << hints.mines.size() << " mines" << std::endl;
+#endif
+    }
+
+    // The guess engine thinks for up to GUESS_BUDGET, so it runs on a snapshot of the board
+    // while frames go on; a result for a position that has since changed is dropped
+    if (guessTask.Ready()) {
+        GuessChoice choice = guessTask.Take();
+        if (guessTaskKey == hintsKey) {
+            hintGuess = choice.cell;
+        }
+    }
+    if (guessPending && !guessTask.Busy()) {
+        std::vector<char> flagged(board.Rows() * board.Cols(), 0);
+        for (int index = 0; index < board.Rows() * board.Cols(); ++index) {
+            flagged[index] = board.AtIndex(index).state == CellState::FLAGGED;
+        }
+        PlayerView view = PlayerView::FromBoard(board);
+        int mineCount = CalculateMineCount();
+        guessPending = false;
+        guessTaskKey = hintsKey;
+        guessTask.Start([this, view, flagged, mineCount]() {
+            return guessEngine.Choose(view, flagged, mineCount, GUESS_BUDGET);
+        });
+    }
+}
+
+void Game::UpdateGhost() {
+    if (!ghostActive) {
+        return;
+    }
+
+    // Only decode the moves that are due at the current game time
+    ReplayMove move;
+    while (ghostReplay.NextDueMove(gameTime, move)) {
+        RevealOutcome outcome = RevealOutcome::NONE;
+        switch (move.type) {
+            case MoveType::REVEAL:
+                outcome = ghostBoard.RevealCell(move.row, move.col, &ghostChanged);
+                break;
+            case MoveType::FLAG:
+                ghostBoard.ToggleFlag(move.row, move.col);
+                break;
+            case MoveType::CHORD:
+                outcome = ghostBoard.RevealAdjacentCells(move.row, move.col, &ghostChanged);
+                break;
+        }
+        if (outcome == RevealOutcome::HIT_MINE || outcome == RevealOutcome::WON) {
+            ghostReplay.Close();
+            break;
+        }
+    }
+
+    if (ghostChanged.empty()) {
+        return;
+    }
+
+    // Paint only the newly revealed cells; the overlay keeps everything painted before
+    BeginTextureMode(ghostOverlayTex);
+    for (int index : ghostChanged) {
+        int row = index / ghostBoard.Cols();
+        int col = index % ghostBoard.Cols();
+        DrawRectangle(gridOffset.x + col * cellSize, gridOffset.y + row * cellSize,
+                      cellSize - 1, cellSize - 1, WHITE);
+    }
+    EndTextureMode();
+    ghostChanged.clear();
+}
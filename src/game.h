@@ -2,6 +2,17 @@
 
 #include "raylib.h"
 #include "globals.h"
+#include "board.h"
+#include "replay.h"
+#include "speedrun.h"
+#include "speculation.h"
+#include "assist.h"
+#include "deduction.h"
+#include "guess.h"
+#include "generator.h"
+#include "heatmap.h"
+#include "particles.h"
+#include "resolution.h"
 #include <vector>
 #include <random>
 
@@ -27,12 +38,6 @@ public:
 #endif
 
 private:
-    struct Cell {
-        bool hasMine;
-        CellState state;
-        int adjacentMines;
-    };
-
     // Menu related
     void DrawMenuBar();
     bool HandleMenuInput();
@@ -49,6 +54,12 @@ private:
     Rectangle aboutOptionRect;
     Rectangle toggleSoundOptionRect;
     Rectangle toggleMusicOptionRect;
+    Rectangle raceGhostOptionRect;
+    Rectangle speedrunOptionRect;
+    Rectangle assistOptionRect;
+    Rectangle hintsOptionRect;
+    Rectangle adaptiveOptionRect;
+    Rectangle heatmapOptionRect;
     Rectangle popupRect;
     Rectangle okButtonRect;
     bool showHelpPopup;
@@ -69,14 +80,11 @@ private:
     int tapCol;
     bool longTapPerformed;  // Track if long tap action has been performed
 
-    void InitializeGrid();
-    void PlaceMines();
-    void CalculateAdjacentMines();
+    void StartNewBoard(unsigned int seed, int mineCount);  // Generate a seeded board and start recording it
     void RevealCell(int row, int col);
-    void RevealAllMines();
-    void RevealNeighboringMines(int row, int col);  // Reveal mines adjacent to a cell
     void RevealAdjacentCells(int row, int col);
-    bool IsValidCell(int row, int col) const;
+    bool ToggleFlag(int row, int col);
+    void UpdateSpeculation(int row, int col);  // Precompute the reveal or chord of the hovered cell
     void CheckWinCondition();
     void DrawGrid() const;
     void DrawCell(int row, int col) const;
@@ -91,7 +99,36 @@ private:
     bool waitingForGameOver;  // Track if we're waiting for player input after losing
 
     float screenScale;
-    RenderTexture2D targetRenderTex;
+    RenderTexture2D targetRenderTex;  // The composited frame, scaled to the window every frame
+
+    // Dynamic resolution: the frame and its layers are rendered at a fraction of the game
+    // screen size, picked from measured frame times, and scaled up to the window as before
+    void ResizeRenderTargets();          // (Re)creates the frame and layer textures at the current scale
+    ResolutionScaler resolution;
+    Camera2D renderCamera;               // Maps game screen coordinates to the render resolution
+    static const float FRAME_BUDGET;     // Seconds per frame at the target frame rate
+
+    // Layered drawing: each layer is cached in its own render texture and repainted only when
+    // it is marked dirty or its key, a hash of the state it is drawn from, changes. The layers
+    // are composited into targetRenderTex only on frames where one of them was repainted, so
+    // the ticking timer repaints the HUD alone and an open menu only the menu layer.
+    enum Layer {
+        LAYER_BACKGROUND,
+        LAYER_BOARD,     // Grid with the hint, heatmap and ghost overlays
+        LAYER_HUD,       // Stats above the grid and the win/lose banners
+        LAYER_MENUS,     // Popups and the menu bar
+        LAYER_COUNT
+    };
+    void InvalidateLayer(Layer layer) { layerDirty[layer] = true; }
+    uint64_t LayerKey(Layer layer) const;
+    void PaintLayer(Layer layer);
+    void DrawBanner();
+    void DrawSplits(int top);  // Speedrun splits so far, in a box starting at y = top
+    void DrawPopups();
+    std::string TimerText() const;  // The HUD timer as shown
+    RenderTexture2D layerTex[LAYER_COUNT];  // Premultiplied alpha, at the render resolution
+    bool layerDirty[LAYER_COUNT];
+    uint64_t layerKeys[LAYER_COUNT];        // Keys the layers were last painted with
     Font font;
 
     // Game stats
@@ -100,8 +137,8 @@ private:
 
     int screenWidth;
     int screenHeight;
-    std::vector<std::vector<Cell>> grid;
-    int remainingCells;
+    Board board;
+    unsigned int boardSeed;
 
     // Scaling related
     float cellSize;
@@ -129,8 +166,94 @@ private:
 
     // Mobile tap constants
     static const float LONG_TAP_THRESHOLD;  // Time in seconds for long tap
+    static const float SATISFIED_NUMBER_ALPHA;  // Opacity of numbers with all their flags placed
+
+    // Speculative reveal of the hovered cell
+    SpeculativeReveal speculation;
+    static const double SPECULATION_BUDGET;  // Seconds of each frame spent on speculation
+    static const int SPECULATION_CHUNK = 4096;  // Cells processed between budget checks
 
     // Save/Load functions
     bool SaveGame(const std::string& filename);
     bool LoadGame(const std::string& filename);
+
+    // Ghost race: the last winning game is replayed on the same seeded board while the player plays
+    bool StartGhostRace();
+    void StopGhost();
+    void UpdateGhost();
+    ReplayRecorder replayRecorder;
+    ReplayReader ghostReplay;
+    Board ghostBoard;
+    bool ghostActive;
+    std::vector<int> ghostChanged;      // Cells revealed by the ghost since the last overlay update
+    RenderTexture2D ghostOverlayTex;    // Ghost progress, painted incrementally
+
+    // Speedrun mode: nanosecond timing of every move and a split per level of the progression
+    void ToggleSpeedrunMode();
+    bool speedrunMode;
+    SpeedrunTimer speedrun;
+    int64_t inputTimestampNs;  // When this frame's input events were polled
+
+    // Assist: flags forced mines and chords satisfied numbers after every player move
+    void RunAssist();
+    bool assistMode;
+    AutoAssist assist;
+    std::vector<int> assistSeeds;        // Cells changed by the player's move
+    std::vector<AssistMove> assistMoves;
+
+    // Hints: cells the visible numbers prove safe or mined, from the SAT-based solver
+    void UpdateHints();
+    bool showHints;
+    DeductionSolver deduction;
+    Deductions hints;
+    uint64_t hintsKey;          // Board generation and unrevealed count the hints were computed for
+    GuessEngine guessEngine;
+    int hintGuess;                       // Suggested guess when nothing is safe, -1 if none
+    static const double GUESS_BUDGET;    // Seconds the guess engine may think for
+    BackgroundTask<GuessChoice> guessTask;  // The guess engine runs off the frame; after guessEngine so it stops first
+    uint64_t guessTaskKey;               // hintsKey the running guess was started for
+    bool guessPending;                   // A guess is wanted but the last one is still running
+
+    // Adaptive difficulty: new boards are picked to fit the player's speed and recent results
+    DifficultyTarget AdaptiveTarget(int level) const;
+    void PrepareAdaptiveBoard();  // Starts generating the board the next Randomize() will want
+    GeneratedBoard NextAdaptiveBoard(int mineCount, unsigned int seed);
+    bool adaptiveMode;
+    BoardGenerator generator;
+    BackgroundTask<GeneratedBoard> generationTask;  // Board generated ahead, after generator so it stops first
+    int preparedSize;                    // Size, mine count and target generationTask is working to
+    int preparedMineCount;
+    DifficultyTarget preparedTarget;
+    int boardValue;                      // 3BV of the current board
+    float playerSpeed;                   // Smoothed 3BV/s over won games
+    int difficultyLevel;                 // 0-3: rules needed and guesses allowed
+    static const int MAX_DIFFICULTY_LEVEL = 3;
+    static const double GENERATION_BUDGET;       // Seconds a new board may take to pick
+    static const float TARGET_LEVEL_SECONDS;     // Time a board should take at the player's speed
+    static const float INITIAL_PLAYER_SPEED;     // 3BV/s assumed before the first win
+    static const float PLAYER_SPEED_SMOOTHING;   // Weight of the latest win in playerSpeed
+
+    // Click heatmap: every reveal, flag and chord is counted per board size and saved across
+    // sessions; the viewer shades the grid with the counts for the current size
+    void RecordClick(MoveType type, int row, int col);
+    void UpdateHeatmapTexture();         // Re-uploads the texture when the counts have changed
+    ClickHeatmap heatmap;
+    bool showHeatmap;
+    unsigned int heatmapSavedVersion;    // Counts as of the last save
+    unsigned int heatmapTexVersion;      // Counts the texture was built from
+    int heatmapTexSize;                  // Grid size the texture was built for
+    Texture2D heatmapTex;                // One texel per cell, or per bin on boards above the resolution
+    std::vector<Color> heatmapPixels;
+
+    // Loss and win effects: sparks burst from the mines and confetti is thrown over the grid.
+    // The pool never allocates; particles are drawn over the board layer in the composite pass.
+    void ExplodeMines(int row, int col);  // From every revealed mine, strongest at (row, col) if valid
+    void ThrowConfetti();
+    void DrawParticles() const;
+    ParticlePool particles;
+    float particleGravity;               // Pixels/s^2 and 1/s for the effect playing
+    float particleDrag;
+    bool particlesDrawn;                 // The composited frame has particles in it
+    Texture2D particleAtlas;             // Spark and confetti sprites side by side
+    static const int PARTICLE_SPRITE_SIZE = 16;
 };
\ No newline at end of file
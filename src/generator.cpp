@@ -0,0 +1,244 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+
+#include "generator.h"
+#include "parallel.h"
+
+namespace {
+    const int MAX_CANDIDATES = 4096;  // Seeds tried before giving up even with budget left
+
+    // Candidate 0 is the base seed itself, so an unmatched target still plays the requested seed
+    unsigned int CandidateSeed(unsigned int baseSeed, int candidate) {
+        if (candidate == 0) {
+            return baseSeed;
+        }
+        uint64_t x = ((uint64_t)baseSeed << 32) + (uint64_t)candidate * 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return (unsigned int)(x ^ (x >> 31));
+    }
+
+    double Gap(int value, int low, int high) {
+        return value < low ? low - value : value > high ? value - high : 0;
+    }
+}
+
+int BoardGenerator::Compute3BV(const Board& board) {
+    int rows = board.Rows();
+    int cols = board.Cols();
+    std::vector<char> covered(rows * cols, 0);
+    std::vector<int> stack;
+    int clicks = 0;
+
+    // Each opening is one click, and clears its numbered border too
+    for (int start = 0; start < rows * cols; ++start) {
+        const Cell& cell = board.AtIndex(start);
+        if (covered[start] || cell.hasMine || cell.adjacentMines != 0) continue;
+        clicks++;
+        covered[start] = 1;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            int index = stack.back();
+            stack.pop_back();
+            if (board.AtIndex(index).adjacentMines != 0) continue;
+            int row = index / cols;
+            int col = index % cols;
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if (!board.IsValidCell(row + dr, col + dc)) continue;
+                    int next = board.Index(row + dr, col + dc);
+                    if (!covered[next]) {
+                        covered[next] = 1;
+                        stack.push_back(next);
+                    }
+                }
+            }
+        }
+    }
+
+    // Every number outside an opening's border needs its own click
+    for (int index = 0; index < rows * cols; ++index) {
+        if (!covered[index] && !board.AtIndex(index).hasMine) {
+            clicks++;
+        }
+    }
+    return clicks;
+}
+
+double BoardGenerator::Distance(const BoardMetrics& metrics, const DifficultyTarget& target) {
+    // 3BV misses are scaled by the width of the range so no single metric dominates
+    double bbbvScale = (double)std::max(1, target.max3bv - target.min3bv + 1);
+    return Gap(metrics.bbbv, target.min3bv, target.max3bv) / bbbvScale +
+           Gap(metrics.guesses, target.minGuesses, target.maxGuesses) +
+           Gap(metrics.maxDepth, target.minDepth, target.maxDepth);
+}
+
+void BoardGenerator::Solver::HiddenAround(int index, std::vector<int>& out) const {
+    out.clear();
+    int row = index / board.Cols();
+    int col = index % board.Cols();
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if (board.IsValidCell(row + dr, col + dc) && board.At(row + dr, col + dc).state == CellState::HIDDEN) {
+                out.push_back(board.Index(row + dr, col + dc));
+            }
+        }
+    }
+}
+
+bool BoardGenerator::Solver::ApplySubsetRule() {
+    // For two numbers A and B: if A needs as many more mines as it has cells B doesn't
+    // see, those cells are all mines and the cells only B sees are all safe
+    int cols = board.Cols();
+    std::vector<int> numbers = board.GetFrontier().Numbers().Items();
+    std::sort(numbers.begin(), numbers.end());
+    for (int a : numbers) {
+        const Cell& cellA = board.AtIndex(a);
+        int minesA = cellA.adjacentMines - cellA.flaggedNeighbors;
+        HiddenAround(a, hiddenA);
+        int rowA = a / cols;
+        int colA = a % cols;
+        for (int dr = -2; dr <= 2; ++dr) {
+            for (int dc = -2; dc <= 2; ++dc) {
+                if ((dr == 0 && dc == 0) || !board.IsValidCell(rowA + dr, colA + dc)) continue;
+                int b = board.Index(rowA + dr, colA + dc);
+                if (!board.GetFrontier().Numbers().Contains(b)) continue;
+                const Cell& cellB = board.AtIndex(b);
+                int minesB = cellB.adjacentMines - cellB.flaggedNeighbors;
+                HiddenAround(b, hiddenB);
+
+                std::vector<int> onlyA;
+                std::vector<int> onlyB;
+                std::set_difference(hiddenA.begin(), hiddenA.end(), hiddenB.begin(), hiddenB.end(),
+                                    std::back_inserter(onlyA));
+                std::set_difference(hiddenB.begin(), hiddenB.end(), hiddenA.begin(), hiddenA.end(),
+                                    std::back_inserter(onlyB));
+                if (onlyB.empty() || minesA - minesB != (int)onlyA.size()) continue;
+
+                for (int index : onlyA) {
+                    board.ToggleFlag(index / cols, index % cols);
+                    changed.push_back(index);
+                }
+                for (int index : onlyB) {
+                    board.RevealCell(index / cols, index % cols, &changed);
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool BoardGenerator::Solver::ApplySat(int mineCount) {
+    if (!deduction.Analyze(board, mineCount, deductions)) {
+        return false;
+    }
+    int cols = board.Cols();
+    for (int index : deductions.mines) {
+        if (board.AtIndex(index).state == CellState::HIDDEN) {
+            board.ToggleFlag(index / cols, index % cols);
+            changed.push_back(index);
+        }
+    }
+    for (int index : deductions.safe) {
+        board.RevealCell(index / cols, index % cols, &changed);
+    }
+    return !deductions.mines.empty() || !deductions.safe.empty();
+}
+
+void BoardGenerator::Solver::Guess() {
+    // The solver knows the mines, so a guess is always lucky; only the number of guesses
+    // matters. Guess next to the numbers when possible, as a player would.
+    int guess = -1;
+    for (int index : board.GetFrontier().Unknowns().Items()) {
+        if (!board.AtIndex(index).hasMine && (guess < 0 || index < guess)) {
+            guess = index;
+        }
+    }
+    for (int index = 0; guess < 0 && index < board.Rows() * board.Cols(); ++index) {
+        const Cell& cell = board.AtIndex(index);
+        if (cell.state == CellState::HIDDEN && !cell.hasMine) {
+            guess = index;
+        }
+    }
+    if (guess >= 0) {
+        board.RevealCell(guess / board.Cols(), guess % board.Cols(), &changed);
+    }
+}
+
+bool BoardGenerator::Solver::Measure(int rows, int cols, int mineCount, unsigned int seed,
+                                     Clock::time_point deadline, BoardMetrics& metrics) {
+    board.Generate(rows, cols, mineCount, seed);
+    metrics = { Compute3BV(board), 0, 0 };
+
+    changed.clear();
+    if (board.RevealCell(0, 0, &changed) == RevealOutcome::HIT_MINE) {
+        return true;
+    }
+    while (board.RemainingCells() > 0) {
+        // The cheapest rule that makes progress sets the depth this step needed
+        if (assist.Run(board, changed, moves) == RevealOutcome::HIT_MINE) {
+            break;
+        }
+        changed.clear();
+        if (!moves.empty()) {
+            metrics.maxDepth = std::max(metrics.maxDepth, 1);
+            if (board.RemainingCells() == 0) break;
+        }
+        if (ApplySubsetRule()) {
+            metrics.maxDepth = std::max(metrics.maxDepth, 2);
+        } else if (Clock::now() >= deadline) {
+            return false;  // The SAT step is the slow one, so the budget is checked before it
+        } else if (ApplySat(mineCount)) {
+            metrics.maxDepth = std::max(metrics.maxDepth, 3);
+        } else {
+            metrics.guesses++;
+            Guess();
+        }
+    }
+    return true;
+}
+
+GeneratedBoard BoardGenerator::Generate(int rows, int cols, int mineCount, const DifficultyTarget& target,
+                                        unsigned int baseSeed, double budgetSeconds) {
+    typedef Solver::Clock Clock;
+    Clock::time_point deadline = Clock::now() +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(budgetSeconds));
+
+    GeneratedBoard best = { baseSeed, { 0, 0, 0 }, false };
+    double bestDistance = -1.0;
+    int bestCandidate = INT_MAX;
+    std::mutex bestMutex;
+    std::atomic<int> nextCandidate(0);
+    std::atomic<int> firstMatch(INT_MAX);
+
+    // Workers claim candidates in order and stop past the first match, so the result is
+    // the lowest matching candidate no matter how many threads ran
+    ParallelFor(WorkerCount(), [&](int) {
+        Solver solver;
+        for (int i = nextCandidate++; i < MAX_CANDIDATES && i < firstMatch; i = nextCandidate++) {
+            unsigned int seed = CandidateSeed(baseSeed, i);
+            BoardMetrics metrics;
+            if (Clock::now() >= deadline || !solver.Measure(rows, cols, mineCount, seed, deadline, metrics)) {
+                break;
+            }
+            double distance = Distance(metrics, target);
+
+            std::lock_guard<std::mutex> lock(bestMutex);
+            if (bestDistance < 0.0 || distance < bestDistance || (distance == bestDistance && i < bestCandidate)) {
+                best = { seed, metrics, distance == 0.0 };
+                bestDistance = distance;
+                bestCandidate = i;
+            }
+            if (distance == 0.0 && i < firstMatch) {
+                firstMatch = i;
+            }
+        }
+    });
+    return best;
+}
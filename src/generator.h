@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "board.h"
+#include "assist.h"
+#include "deduction.h"
+
+// How hard a board is to clear, measured by playing it out with the logical solver
+struct BoardMetrics {
+    int bbbv;            // 3BV: fewest clicks that clear the board (openings plus lone numbers)
+    int guesses;         // Times the solver ran out of deductions and had to guess
+    int maxDepth;        // Hardest rule needed: 1 single number, 2 pair of numbers, 3 full SAT
+};
+
+// Acceptable ranges for each metric, inclusive
+struct DifficultyTarget {
+    int min3bv;
+    int max3bv;
+    int minGuesses;
+    int maxGuesses;
+    int minDepth;
+    int maxDepth;
+};
+
+struct GeneratedBoard {
+    unsigned int seed;     // Board::Generate seed, so replays and ghosts still work from the seed
+    BoardMetrics metrics;
+    bool matched;          // False if the budget ran out and the closest candidate was used
+};
+
+// Produces seeds whose boards fit a difficulty target. Candidate seeds are played out on
+// worker threads with a cheap solver (single numbers, then number pairs, then SAT only
+// when both are stuck), and the lowest matching candidate index wins. Generation never
+// takes longer than its budget: when it runs out, the closest candidate measured is returned,
+// or the plain base seed if not even one board could be played out in time.
+class BoardGenerator
+{
+public:
+    GeneratedBoard Generate(int rows, int cols, int mineCount, const DifficultyTarget& target,
+                            unsigned int baseSeed, double budgetSeconds);
+
+    static int Compute3BV(const Board& board);
+    static double Distance(const BoardMetrics& metrics, const DifficultyTarget& target);  // 0 if it matches
+
+    // Plays a generated board out from the always-safe corner
+    class Solver
+    {
+    public:
+        typedef std::chrono::steady_clock Clock;
+        // Returns false if the deadline passed before the board was cleared
+        bool Measure(int rows, int cols, int mineCount, unsigned int seed, Clock::time_point deadline,
+                     BoardMetrics& metrics);
+
+    private:
+        bool ApplySubsetRule();
+        bool ApplySat(int mineCount);
+        void Guess();
+        void HiddenAround(int index, std::vector<int>& out) const;
+
+        Board board;
+        AutoAssist assist;
+        DeductionSolver deduction;
+        Deductions deductions;
+        std::vector<AssistMove> moves;
+        std::vector<int> changed;
+        std::vector<int> hiddenA;
+        std::vector<int> hiddenB;
+    };
+};
@@ -28,10 +28,6 @@ const int GRID_SIZE = 8;
 const int CELL_SIZE = 50;
 const int NUM_MINES = 10;
 const float MUSIC_VOLUME = 0.33f;
-
-// Cell states
-enum class CellState {
-    HIDDEN,
-    REVEALED,
-    FLAGGED
-};
+const char* const GHOST_REPLAY_FILE = "ghost.rep";  // Last winning game, raced against as a ghost
+const char* const HEATMAP_FILE = "heatmap.dat";     // Click counts, accumulated across sessions
+const char* const SPEEDRUN_FILE = "speedrun.txt";   // Splits and move times of the last finished speedrun
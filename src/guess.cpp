@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "guess.h"
+#include "parallel.h"
+
+namespace {
+    const int DEFAULT_DEPTH = 2;
+    const int ROOT_CANDIDATES = 8;    // Guesses scored at the top level
+    const int INNER_CANDIDATES = 4;   // and deeper in the lookahead
+    const size_t MEMO_LIMIT = 1 << 18;
+    const double SAFE_EPSILON = 1e-12;
+}
+
+GuessEngine::GuessEngine()
+    : depth(DEFAULT_DEPTH), totalMines(0)
+{
+}
+
+uint64_t GuessEngine::MemoKey(const PlayerView& view, int depth) const {
+    uint64_t key = view.Hash();
+    key ^= ((uint64_t)depth << 56) ^ ((uint64_t)totalMines * 0x9E3779B97F4A7C15ULL);
+    return key;
+}
+
+void GuessEngine::Candidates(const PlayerView& view, const ProbabilityResult& probabilities,
+                             const std::vector<char>* excluded, int limit, std::vector<int>& out) const {
+    // Lowest mine probability first; among equals, cells with fewer unrevealed neighbours
+    // (corners, edges) are more likely to open up. Interior cells are all alike, so one
+    // of them stands in for the rest.
+    struct Entry {
+        double probability;
+        int unrevealedNeighbors;
+        int cell;
+        bool interior;
+    };
+    std::vector<Entry> entries;
+    for (int index = 0; index < view.rows * view.cols; ++index) {
+        if (view.cells[index] != PlayerView::UNREVEALED || (excluded && (*excluded)[index])) continue;
+        double probability = probabilities.mineProbability[index];
+        if (probability >= 1.0 - SAFE_EPSILON) continue;
+
+        int row = index / view.cols;
+        int col = index % view.cols;
+        int unrevealed = 0;
+        bool interior = true;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if ((dr == 0 && dc == 0) || !view.IsValidCell(row + dr, col + dc)) continue;
+                if (view.cells[(row + dr) * view.cols + col + dc] == PlayerView::UNREVEALED) {
+                    unrevealed++;
+                } else {
+                    interior = false;
+                }
+            }
+        }
+        entries.push_back({ probability, unrevealed, index, interior });
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.probability != b.probability) return a.probability < b.probability;
+        return a.unrevealedNeighbors < b.unrevealedNeighbors;
+    });
+
+    out.clear();
+    bool interiorTaken = false;
+    for (const Entry& entry : entries) {
+        if ((int)out.size() >= limit) break;
+        if (entry.interior) {
+            if (interiorTaken) continue;
+            interiorTaken = true;
+        }
+        out.push_back(entry.cell);
+    }
+}
+
+GuessEngine::Position GuessEngine::Evaluate(ProbabilitySolver& solver, const PlayerView& view, int depth,
+                                            Clock::time_point deadline) {
+    uint64_t key = MemoKey(view, depth);
+    {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        auto found = memo.find(key);
+        if (found != memo.end()) {
+            return found->second;
+        }
+    }
+
+    ProbabilityResult probabilities;
+    if (!solver.Solve(view, totalMines, probabilities)) {
+        return { 0.0, -INFINITY };
+    }
+    Position position = { 0.0, probabilities.logWeight };
+
+    // Won, or a safe move exists: progress is certain
+    int unrevealed = 0;
+    double bestSurvival = 0.0;
+    for (int index = 0; index < view.rows * view.cols; ++index) {
+        if (view.cells[index] != PlayerView::UNREVEALED) continue;
+        unrevealed++;
+        bestSurvival = std::max(bestSurvival, 1.0 - probabilities.mineProbability[index]);
+    }
+    if (unrevealed == totalMines || bestSurvival >= 1.0 - SAFE_EPSILON) {
+        position.value = 1.0;
+    } else if (depth == 0 || Clock::now() >= deadline) {
+        position.value = bestSurvival;
+    } else {
+        std::vector<int> candidates;
+        Candidates(view, probabilities, nullptr, INNER_CANDIDATES, candidates);
+        for (int cell : candidates) {
+            position.value = std::max(position.value, GuessValue(solver, view, probabilities.logWeight, cell, depth, deadline));
+        }
+    }
+
+    // A result cut short by the deadline is only a lower bound, so don't keep it
+    if (Clock::now() < deadline) {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        if (memo.size() >= MEMO_LIMIT) {
+            memo.clear();
+        }
+        memo[key] = position;
+    }
+    return position;
+}
+
+double GuessEngine::GuessValue(ProbabilitySolver& solver, const PlayerView& view, double logWeight,
+                               int cell, int depth, Clock::time_point deadline) {
+    // Sum over every number the cell could show, weighted by the share of layouts showing it.
+    // Layouts with a mine in the cell contribute nothing.
+    int row = cell / view.cols;
+    int col = cell % view.cols;
+    int neighbors = 0;
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if ((dr != 0 || dc != 0) && view.IsValidCell(row + dr, col + dc)) {
+                neighbors++;
+            }
+        }
+    }
+
+    PlayerView next = view;
+    double value = 0.0;
+    for (int number = 0; number <= neighbors; ++number) {
+        next.cells[cell] = (signed char)number;
+        Position outcome = Evaluate(solver, next, depth - 1, deadline);
+        if (outcome.logWeight == -INFINITY) continue;
+        value += std::exp(outcome.logWeight - logWeight) * outcome.value;
+    }
+    return value;
+}
+
+GuessChoice GuessEngine::Choose(const Board& board, int totalMines, double budgetSeconds) {
+    // Never suggest a cell the player has flagged
+    std::vector<char> flagged(board.Rows() * board.Cols(), 0);
+    for (int index = 0; index < board.Rows() * board.Cols(); ++index) {
+        flagged[index] = board.AtIndex(index).state == CellState::FLAGGED;
+    }
+    return Choose(PlayerView::FromBoard(board), flagged, totalMines, budgetSeconds);
+}
+
+GuessChoice GuessEngine::Choose(const PlayerView& view, const std::vector<char>& flagged, int totalMines,
+                                double budgetSeconds) {
+    GuessChoice choice = { -1, 1.0, 0.0 };
+    Clock::time_point deadline = Clock::now() +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(budgetSeconds));
+    {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        if (totalMines != this->totalMines) {
+            memo.clear();
+        }
+    }
+    this->totalMines = totalMines;
+
+    ProbabilitySolver solver;
+    ProbabilityResult probabilities;
+    if (!solver.Solve(view, totalMines, probabilities)) {
+        return choice;
+    }
+
+    std::vector<int> candidates;
+    Candidates(view, probabilities, &flagged, ROOT_CANDIDATES, candidates);
+    if (candidates.empty()) {
+        return choice;
+    }
+
+    // Score the candidates in parallel; each worker has its own solver, the memo is shared
+    std::vector<double> values(candidates.size(), 0.0);
+    std::atomic<int> nextCandidate(0);
+    ParallelFor(std::min(WorkerCount(), (int)candidates.size()), [&](int) {
+        ProbabilitySolver workerSolver;
+        for (int i = nextCandidate++; i < (int)candidates.size(); i = nextCandidate++) {
+            int cell = candidates[i];
+            values[i] = probabilities.mineProbability[cell] < SAFE_EPSILON ? 1.0 :
+                GuessValue(workerSolver, view, probabilities.logWeight, cell, depth, deadline);
+        }
+    });
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        double probability = probabilities.mineProbability[candidates[i]];
+        if (choice.cell < 0 || values[i] > choice.successProbability + SAFE_EPSILON ||
+            (values[i] > choice.successProbability - SAFE_EPSILON && probability < choice.mineProbability)) {
+            choice = { candidates[i], probability, values[i] };
+        }
+    }
+    return choice;
+}
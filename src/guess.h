@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "board.h"
+#include "probability.h"
+
+struct GuessChoice {
+    int cell;                   // -1 if no guess could be evaluated
+    double mineProbability;
+    double successProbability;  // Chance of surviving and reaching a position with a safe move
+};
+
+// Picks the guess most likely to lead somewhere, not just the one least likely to be a
+// mine: each candidate is scored by a depth-limited expectimax over the numbers it could
+// show, weighted by how many mine layouts give each number. Candidates are scored in
+// parallel under a time budget, and positions are memoized by view hash so transpositions
+// and repeated calls on the same board are free.
+class GuessEngine
+{
+public:
+    GuessEngine();
+
+    GuessChoice Choose(const Board& board, int totalMines, double budgetSeconds);
+    // The same from a snapshot, so it can run while the board itself keeps changing;
+    // flagged marks the cells never to suggest
+    GuessChoice Choose(const PlayerView& view, const std::vector<char>& flagged, int totalMines, double budgetSeconds);
+    void SetDepth(int depth) { this->depth = depth; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Position {
+        double value;      // Success probability with best play
+        double logWeight;  // Mine layouts the position allows, as in ProbabilityResult
+    };
+
+    Position Evaluate(ProbabilitySolver& solver, const PlayerView& view, int depth, Clock::time_point deadline);
+    double GuessValue(ProbabilitySolver& solver, const PlayerView& view, double logWeight,
+                      int cell, int depth, Clock::time_point deadline);
+    void Candidates(const PlayerView& view, const ProbabilityResult& probabilities,
+                    const std::vector<char>* excluded, int limit, std::vector<int>& out) const;
+    uint64_t MemoKey(const PlayerView& view, int depth) const;
+
+    int depth;
+    int totalMines;
+    std::mutex memoMutex;
+    std::unordered_map<uint64_t, Position> memo;
+};
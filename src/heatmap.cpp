@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#include "heatmap.h"
+
+const int ClickHeatmap::RESOLUTION;
+const int ClickHeatmap::MAX_TRACKED_SIZE;
+const int ClickHeatmap::MOVE_TYPES;
+
+namespace {
+    const char HEATMAP_MAGIC[4] = { 'M', 'S', 'H', 'M' };
+    const unsigned char HEATMAP_VERSION = 1;
+    const int SIZE_SLOTS = ClickHeatmap::MAX_TRACKED_SIZE;
+    const int BINS = ClickHeatmap::RESOLUTION * ClickHeatmap::RESOLUTION;
+
+    // Counts saturate instead of wrapping, so a hot bin never turns cold
+    void AddSaturating(uint32_t& count, uint32_t amount) {
+        count = amount > UINT32_MAX - count ? UINT32_MAX : count + amount;
+    }
+}
+
+ClickHeatmap::ClickHeatmap()
+    : counts(SIZE_SLOTS * MOVE_TYPES * BINS, 0), version(0)
+{
+}
+
+int ClickHeatmap::SizeSlot(int rows, int cols) {
+    return std::min(std::max(rows, cols), MAX_TRACKED_SIZE) - 1;
+}
+
+int ClickHeatmap::Offset(int slot, MoveType type, int binRow, int binCol) {
+    return (slot * MOVE_TYPES + static_cast<int>(type)) * BINS + binRow * RESOLUTION + binCol;
+}
+
+void ClickHeatmap::Record(MoveType type, int row, int col, int rows, int cols) {
+    if (row < 0 || row >= rows || col < 0 || col >= cols) {
+        return;
+    }
+    AddSaturating(counts[Offset(SizeSlot(rows, cols), type, Bin(row, rows), Bin(col, cols))], 1);
+    version++;
+}
+
+void ClickHeatmap::Clear() {
+    std::fill(counts.begin(), counts.end(), 0);
+    version++;
+}
+
+uint32_t ClickHeatmap::Count(int rows, int cols, MoveType type, int binRow, int binCol) const {
+    return counts[Offset(SizeSlot(rows, cols), type, binRow, binCol)];
+}
+
+uint32_t ClickHeatmap::Total(int rows, int cols, int binRow, int binCol) const {
+    uint32_t total = 0;
+    for (int type = 0; type < MOVE_TYPES; ++type) {
+        AddSaturating(total, Count(rows, cols, static_cast<MoveType>(type), binRow, binCol));
+    }
+    return total;
+}
+
+void ClickHeatmap::Merge(const ClickHeatmap& other) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+        AddSaturating(counts[i], other.counts[i]);
+    }
+    version++;
+}
+
+// File layout: "MSHM", version byte, resolution and size slot count bytes, then every count
+// as a little-endian 32-bit word in the in-memory order
+bool ClickHeatmap::Load(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[4];
+    unsigned char layout[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(layout), sizeof(layout));
+    if (!file || std::memcmp(magic, HEATMAP_MAGIC, sizeof(magic)) != 0 || layout[0] != HEATMAP_VERSION ||
+        layout[1] != RESOLUTION || layout[2] != SIZE_SLOTS) {
+#ifdef DEBUG
+        std::cerr << "Not a heatmap file: " << filename << std::endl;
+#endif
+        return false;
+    }
+
+    std::vector<unsigned char> data(counts.size() * 4);
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    if (!file) {
+        return false;
+    }
+    for (size_t i = 0; i < counts.size(); ++i) {
+        const unsigned char* bytes = &data[i * 4];
+        AddSaturating(counts[i], bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24));
+    }
+    version++;
+    return true;
+}
+
+bool ClickHeatmap::Save(const std::string& filename) const {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+#ifdef DEBUG
+        std::cerr << "Failed to open heatmap file for saving: " << filename << std::endl;
+#endif
+        return false;
+    }
+
+    std::vector<unsigned char> data;
+    data.reserve(sizeof(HEATMAP_MAGIC) + 3 + counts.size() * 4);
+    data.insert(data.end(), HEATMAP_MAGIC, HEATMAP_MAGIC + sizeof(HEATMAP_MAGIC));
+    data.push_back(HEATMAP_VERSION);
+    data.push_back(RESOLUTION);
+    data.push_back(SIZE_SLOTS);
+    for (uint32_t count : counts) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            data.push_back(static_cast<unsigned char>(count >> shift));
+        }
+    }
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
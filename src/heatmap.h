@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "replay.h"
+
+// Where players click, for tuning board sizes and layouts. Clicks are normalized to a fixed
+// RESOLUTION x RESOLUTION grid of bins per board size and per kind of move, so a cell maps
+// to the same bin on every board of its size. Boards up to MAX_TRACKED_SIZE cells on their
+// longer side get a grid each; larger ones share the last. All grids are allocated once, so
+// recording a click is a single increment with no allocation.
+class ClickHeatmap
+{
+public:
+    static const int RESOLUTION = 32;
+    static const int MAX_TRACKED_SIZE = 32;
+    static const int MOVE_TYPES = 3;  // REVEAL, FLAG, CHORD
+
+    ClickHeatmap();
+
+    void Record(MoveType type, int row, int col, int rows, int cols);
+    void Clear();
+
+    // Count of one kind of click in a bin of the grid used for rows x cols boards
+    uint32_t Count(int rows, int cols, MoveType type, int binRow, int binCol) const;
+    uint32_t Total(int rows, int cols, int binRow, int binCol) const;  // All kinds of click
+
+    // Bin of a row or column; boards up to RESOLUTION cells across get one bin per cell
+    static int Bin(int index, int size) { return index * RESOLUTION / size; }
+
+    unsigned int Version() const { return version; }  // Changes whenever a count does
+
+    // Adds another heatmap's counts to this one
+    void Merge(const ClickHeatmap& other);
+
+    // Load adds the file's counts to the current ones, so clicks from earlier sessions
+    // accumulate; it returns false and leaves the counts alone if the file isn't a heatmap
+    bool Load(const std::string& filename);
+    bool Save(const std::string& filename) const;
+
+private:
+    static int SizeSlot(int rows, int cols);
+    static int Offset(int slot, MoveType type, int binRow, int binCol);
+
+    std::vector<uint32_t> counts;  // [size slot][move type][bin row][bin col]
+    unsigned int version;
+};
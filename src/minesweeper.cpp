@@ -0,0 +1,253 @@
+#define MINESWEEPER_BUILD
+#include "minesweeper.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "board.h"
+
+static_assert(sizeof(int) == sizeof(int32_t), "ms_board_changed copies ints as int32_t");
+
+struct ms_board {
+    Board board;
+    int mineCount;
+    int status;
+    std::vector<int> changed;  // Cells the last move revealed
+};
+
+namespace {
+    const char SAVE_MAGIC[4] = { 'M', 'S', 'B', 'D' };
+    const uint8_t SAVE_VERSION = 1;
+    const size_t SAVE_HEADER_SIZE = 14;      // Magic, version, rows, cols, status
+    const int64_t MAX_CELLS = 1 << 28;       // Keeps every cell index in an int
+    const uint8_t SAVE_MINE_BIT = 4;         // Cell byte: state in the low two bits, then the mine
+
+    bool ValidSize(int rows, int cols) {
+        return rows > 0 && cols > 0 && (int64_t)rows * cols <= MAX_CELLS;
+    }
+
+    bool ValidRegion(const ms_board* board, int row, int col, int height, int width, const uint8_t* out, size_t stride) {
+        return board && out && row >= 0 && col >= 0 && height >= 0 && width >= 0 && stride >= (size_t)width &&
+               row + (int64_t)height <= board->board.Rows() && col + (int64_t)width <= board->board.Cols();
+    }
+
+    void PutU32(uint8_t* out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) out[i] = (uint8_t)(value >> (8 * i));
+    }
+
+    uint32_t GetU32(const uint8_t* in) {
+        return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t)in[3] << 24);
+    }
+
+    int Generate(ms_board* board, int rows, int cols, int mineCount, uint32_t seed) {
+        if (mineCount < 0) {
+            mineCount = Board::DefaultMineCount(rows, cols);
+        }
+        board->board.Generate(rows, cols, mineCount, seed);
+        board->mineCount = rows * cols - board->board.RemainingCells();  // After clamping
+        board->status = MS_STATUS_PLAYING;
+        board->changed.clear();
+        return 0;
+    }
+
+    // Runs a move the way the game does and keeps the status up to date
+    int Play(ms_board* board, int type, int row, int col) {
+        if (!board || !board->board.IsValidCell(row, col)) {
+            return MS_INVALID;
+        }
+        board->changed.clear();
+        if (board->status != MS_STATUS_PLAYING) {
+            return MS_NONE;
+        }
+        try {
+            RevealOutcome outcome;
+            if (type == MS_MOVE_REVEAL) {
+                outcome = board->board.RevealCell(row, col, &board->changed);
+                if (outcome == RevealOutcome::HIT_MINE) {
+                    board->board.RevealAllMines();
+                }
+            } else if (type == MS_MOVE_CHORD) {
+                outcome = board->board.RevealAdjacentCells(row, col, &board->changed);
+            } else if (type == MS_MOVE_FLAG) {
+                return board->board.ToggleFlag(row, col) ? MS_CHANGED : MS_NONE;
+            } else {
+                return MS_INVALID;
+            }
+
+            if (outcome == RevealOutcome::HIT_MINE) {
+                board->status = MS_STATUS_LOST;
+                return MS_HIT_MINE;
+            }
+            if (outcome == RevealOutcome::WON || (outcome == RevealOutcome::REVEALED && board->board.RemainingCells() == 0)) {
+                board->status = MS_STATUS_WON;
+                return MS_WON;
+            }
+            return outcome == RevealOutcome::NONE ? MS_NONE : MS_CHANGED;
+        } catch (const std::exception&) {
+            return MS_INVALID;  // Out of memory; exceptions must not cross into C
+        }
+    }
+
+    // Fills a region through the board's storage order, one byte per cell from code(cell)
+    template <typename Code>
+    int FillRegion(const ms_board* board, int row, int col, int height, int width, uint8_t* out, size_t stride, Code code) {
+        if (!ValidRegion(board, row, col, height, width, out, stride)) {
+            return -1;
+        }
+        board->board.ForEachCellIn(row, row + height, col, col + width, [&](int r, int c, const Cell& cell) {
+            out[(size_t)(r - row) * stride + (c - col)] = code(cell);
+        });
+        return height * width;
+    }
+}
+
+int ms_api_version(void) {
+    return MS_API_VERSION;
+}
+
+ms_board* ms_board_create(int rows, int cols, int mine_count, uint32_t seed) {
+    if (!ValidSize(rows, cols)) {
+        return nullptr;
+    }
+    try {
+        ms_board* board = new ms_board();
+        Generate(board, rows, cols, mine_count, seed);
+        return board;
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void ms_board_destroy(ms_board* board) {
+    delete board;
+}
+
+int ms_board_generate(ms_board* board, int rows, int cols, int mine_count, uint32_t seed) {
+    if (!board || !ValidSize(rows, cols)) {
+        return -1;
+    }
+    try {
+        return Generate(board, rows, cols, mine_count, seed);
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+int ms_board_rows(const ms_board* board) { return board ? board->board.Rows() : 0; }
+int ms_board_cols(const ms_board* board) { return board ? board->board.Cols() : 0; }
+int ms_board_mine_count(const ms_board* board) { return board ? board->mineCount : 0; }
+int ms_board_flag_count(const ms_board* board) { return board ? board->board.FlagCount() : 0; }
+int ms_board_remaining(const ms_board* board) { return board ? board->board.RemainingCells() : 0; }
+int ms_board_status(const ms_board* board) { return board ? board->status : MS_STATUS_PLAYING; }
+
+int ms_board_reveal(ms_board* board, int row, int col) { return Play(board, MS_MOVE_REVEAL, row, col); }
+int ms_board_flag(ms_board* board, int row, int col) { return Play(board, MS_MOVE_FLAG, row, col); }
+int ms_board_chord(ms_board* board, int row, int col) { return Play(board, MS_MOVE_CHORD, row, col); }
+
+int ms_board_play(ms_board* board, const ms_move* moves, size_t count, int8_t* outcomes) {
+    if (!board || (!moves && count > 0)) {
+        return MS_INVALID;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        int outcome = Play(board, moves[i].type, moves[i].row, moves[i].col);
+        if (outcomes) {
+            outcomes[i] = (int8_t)outcome;
+        }
+    }
+    return board->status;
+}
+
+size_t ms_board_changed(const ms_board* board, int32_t* out, size_t capacity) {
+    if (!board) {
+        return 0;
+    }
+    size_t count = board->changed.size();
+    if (out && capacity > 0) {
+        std::memcpy(out, board->changed.data(), std::min(count, capacity) * sizeof(int32_t));
+    }
+    return count;
+}
+
+int ms_board_view(const ms_board* board, int row, int col, int height, int width, uint8_t* out, size_t stride) {
+    return FillRegion(board, row, col, height, width, out, stride, [](const Cell& cell) -> uint8_t {
+        if (cell.state == CellState::HIDDEN) return MS_CELL_HIDDEN;
+        if (cell.state == CellState::FLAGGED) return MS_CELL_FLAGGED;
+        return cell.hasMine ? (uint8_t)MS_CELL_MINE : (uint8_t)cell.adjacentMines;
+    });
+}
+
+int ms_board_solution(const ms_board* board, int row, int col, int height, int width, uint8_t* out, size_t stride) {
+    return FillRegion(board, row, col, height, width, out, stride, [](const Cell& cell) -> uint8_t {
+        return cell.hasMine ? (uint8_t)MS_CELL_MINE : (uint8_t)cell.adjacentMines;
+    });
+}
+
+// Layout: "MSBD", version byte, rows and cols as little-endian u32, status byte, then one
+// byte per cell in row-major order: the CellState in the low two bits and SAVE_MINE_BIT
+size_t ms_board_serialize(const ms_board* board, uint8_t* buffer, size_t capacity) {
+    if (!board) {
+        return 0;
+    }
+    int rows = board->board.Rows();
+    int cols = board->board.Cols();
+    size_t size = SAVE_HEADER_SIZE + (size_t)rows * cols;
+    if (!buffer || capacity < size) {
+        return size;
+    }
+    std::memcpy(buffer, SAVE_MAGIC, sizeof(SAVE_MAGIC));
+    buffer[4] = SAVE_VERSION;
+    PutU32(buffer + 5, (uint32_t)rows);
+    PutU32(buffer + 9, (uint32_t)cols);
+    buffer[13] = (uint8_t)board->status;
+    uint8_t* cells = buffer + SAVE_HEADER_SIZE;
+    board->board.ForEachCell([&](int row, int col, const Cell& cell) {
+        cells[(size_t)row * cols + col] = (uint8_t)cell.state | (cell.hasMine ? SAVE_MINE_BIT : 0);
+    });
+    return size;
+}
+
+int ms_board_deserialize(ms_board* board, const uint8_t* data, size_t size) {
+    if (!board || !data || size < SAVE_HEADER_SIZE || std::memcmp(data, SAVE_MAGIC, sizeof(SAVE_MAGIC)) != 0 ||
+        data[4] != SAVE_VERSION) {
+        return -1;
+    }
+    uint32_t rows = GetU32(data + 5);
+    uint32_t cols = GetU32(data + 9);
+    int status = data[13];
+    if (rows > (uint32_t)MAX_CELLS || cols > (uint32_t)MAX_CELLS || !ValidSize((int)rows, (int)cols) ||
+        size != SAVE_HEADER_SIZE + (size_t)rows * cols || status > MS_STATUS_WON) {
+        return -1;
+    }
+    const uint8_t* cells = data + SAVE_HEADER_SIZE;
+    for (size_t i = 0; i < (size_t)rows * cols; ++i) {
+        if ((cells[i] & ~(SAVE_MINE_BIT | 3)) != 0 || (cells[i] & 3) > (uint8_t)CellState::FLAGGED) {
+            return -1;
+        }
+    }
+
+    // As when the game loads a save: set mines and states directly, then rebuild the rest
+    try {
+        Board& target = board->board;
+        target.Reset((int)rows, (int)cols);
+        int mineCount = 0;
+        int remaining = 0;
+        target.ForEachCell([&](int row, int col, Cell& cell) {
+            uint8_t saved = cells[(size_t)row * cols + col];
+            cell.hasMine = (saved & SAVE_MINE_BIT) != 0;
+            cell.state = (CellState)(saved & 3);
+            mineCount += cell.hasMine;
+            remaining += !cell.hasMine && cell.state != CellState::REVEALED;
+        });
+        target.CalculateAdjacentMines();
+        target.RebuildIndexes();
+        target.SetRemainingCells(remaining);
+        board->mineCount = mineCount;
+        board->status = status;
+        board->changed.clear();
+        return 0;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
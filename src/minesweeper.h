@@ -0,0 +1,118 @@
+#ifndef MINESWEEPER_H
+#define MINESWEEPER_H
+
+/* C interface to the game rules, built as the libminesweeper shared library for tools in
+ * other languages. Boards are opaque handles. Moves reuse buffers kept in the handle, so
+ * they only allocate while those grow to the largest move seen, and cells are read in bulk
+ * into caller buffers, so a call through FFI costs little more than the move itself.
+ * Starting a game (create, generate, deserialize) rebuilds the board's indexes and does
+ * allocate. A handle must only be used by one thread at a time; different handles can be
+ * used from different threads.
+ *
+ * Cell buffers are row-major, one byte per cell, row r of a region at out[r * stride]. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(MINESWEEPER_BUILD)
+#    define MS_API __declspec(dllexport)
+#  else
+#    define MS_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define MS_API __attribute__((visibility("default")))
+#else
+#  define MS_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MS_API_VERSION 1
+
+typedef struct ms_board ms_board;
+
+/* What the player sees in a cell: 0 to 8 for a revealed number */
+enum {
+    MS_CELL_HIDDEN = 9,
+    MS_CELL_FLAGGED = 10,
+    MS_CELL_MINE = 11   /* A revealed mine, or any mine in ms_board_solution */
+};
+
+/* Result of a move */
+enum {
+    MS_INVALID = -1,    /* Bad handle, cell or move type */
+    MS_NONE = 0,        /* Nothing changed */
+    MS_CHANGED = 1,     /* Safe cells were revealed, or a flag was toggled */
+    MS_HIT_MINE = 2,    /* The game is lost */
+    MS_WON = 3          /* The last safe cell was revealed */
+};
+
+/* Game status */
+enum {
+    MS_STATUS_PLAYING = 0,
+    MS_STATUS_LOST = 1,
+    MS_STATUS_WON = 2
+};
+
+enum {
+    MS_MOVE_REVEAL = 0,
+    MS_MOVE_FLAG = 1,   /* Flag or unflag */
+    MS_MOVE_CHORD = 2
+};
+
+typedef struct ms_move {
+    int32_t type;
+    int32_t row;
+    int32_t col;
+} ms_move;
+
+MS_API int ms_api_version(void);
+
+/* The same seed gives the same board as the game. A negative mine count uses the game's
+ * density. Returns NULL for sizes below 1x1 or out of memory. */
+MS_API ms_board* ms_board_create(int rows, int cols, int mine_count, uint32_t seed);
+MS_API void ms_board_destroy(ms_board* board);
+/* Starts a new game on an existing handle, reusing its memory when the size is unchanged.
+ * Returns 0, or -1 for a bad size or out of memory. */
+MS_API int ms_board_generate(ms_board* board, int rows, int cols, int mine_count, uint32_t seed);
+
+MS_API int ms_board_rows(const ms_board* board);
+MS_API int ms_board_cols(const ms_board* board);
+MS_API int ms_board_mine_count(const ms_board* board);
+MS_API int ms_board_flag_count(const ms_board* board);
+MS_API int ms_board_remaining(const ms_board* board);   /* Safe cells still hidden */
+MS_API int ms_board_status(const ms_board* board);
+
+/* Moves follow the game: a reveal that hits a mine shows all the mines, and once the game
+ * is won or lost moves change nothing and return MS_NONE */
+MS_API int ms_board_reveal(ms_board* board, int row, int col);
+MS_API int ms_board_flag(ms_board* board, int row, int col);
+MS_API int ms_board_chord(ms_board* board, int row, int col);
+/* Plays count moves; outcomes (optional) receives each move's result. Returns the status. */
+MS_API int ms_board_play(ms_board* board, const ms_move* moves, size_t count, int8_t* outcomes);
+/* Row-major indices of the cells the last move revealed. Returns how many there were, which
+ * may be more than capacity; only the first capacity are written. */
+MS_API size_t ms_board_changed(const ms_board* board, int32_t* out, size_t capacity);
+
+/* The player's view (0-8 or MS_CELL_*) of rows [row, row + height) and columns
+ * [col, col + width), which must lie within the board. Returns the cells written, or -1. */
+MS_API int ms_board_view(const ms_board* board, int row, int col, int height, int width,
+                         uint8_t* out, size_t stride);
+/* The same region with everything revealed: 0-8 or MS_CELL_MINE */
+MS_API int ms_board_solution(const ms_board* board, int row, int col, int height, int width,
+                             uint8_t* out, size_t stride);
+
+/* Writes the whole game to buffer if it fits. Returns the size needed, so a NULL buffer
+ * asks for the size; 0 for a bad handle. */
+MS_API size_t ms_board_serialize(const ms_board* board, uint8_t* buffer, size_t capacity);
+/* Replaces the game on an existing handle. Returns 0, or -1 if the data isn't a board. */
+MS_API int ms_board_deserialize(ms_board* board, const uint8_t* data, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
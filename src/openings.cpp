@@ -0,0 +1,182 @@
+#include <algorithm>
+
+#include "openings.h"
+#include "board.h"
+#include "parallel.h"
+
+OpeningIndex::OpeningIndex()
+{
+    Clear();
+}
+
+void OpeningIndex::Clear() {
+    openingOf.clear();
+    spanStart.assign(1, 0);
+    spans.clear();
+    zeroCount.clear();
+    touchedCount.clear();
+}
+
+int OpeningIndex::Find(int label) {
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];  // Path halving
+        label = parent[label];
+    }
+    return label;
+}
+
+void OpeningIndex::Build(const Board& board) {
+    Clear();
+    int rows = board.Rows();
+    int cols = board.Cols();
+    int cellCount = rows * cols;
+    int stripeCount = StripeCount(rows);
+    openingOf.assign(cellCount, -1);
+    parent.assign(cellCount, -1);  // Union-find over zero cells, labelled by cell index
+
+    // Label zero cells stripe by stripe in row-major sweeps, merging with the neighbours already
+    // visited (west, north-west, north, north-east), which is enough for 8-connectivity. A stripe
+    // only links its own cells, so stripes can be labelled at the same time.
+    const int previousOffsets[4][2] = { {0, -1}, {-1, -1}, {-1, 0}, {-1, 1} };
+    ParallelFor(stripeCount, [&](int stripe) {
+        int rowBegin = stripe * STRIPE_ROWS;
+        int rowEnd = std::min(rows, rowBegin + STRIPE_ROWS);
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            for (int col = 0; col < cols; ++col) {
+                const Cell& cell = board.At(row, col);
+                if (cell.hasMine || cell.adjacentMines != 0) {
+                    continue;
+                }
+                int index = row * cols + col;
+                parent[index] = index;
+                for (const auto& offset : previousOffsets) {
+                    int newRow = row + offset[0];
+                    int newCol = col + offset[1];
+                    if (newRow < rowBegin || newCol < 0 || newCol >= cols || parent[newRow * cols + newCol] < 0) {
+                        continue;
+                    }
+                    Union(index, newRow * cols + newCol);
+                }
+            }
+        }
+    });
+
+    // Stitch each stripe's first row to the row above it
+    for (int stripe = 1; stripe < stripeCount; ++stripe) {
+        int row = stripe * STRIPE_ROWS;
+        for (int col = 0; col < cols; ++col) {
+            int index = row * cols + col;
+            if (parent[index] < 0) {
+                continue;
+            }
+            for (int dc = -1; dc <= 1; ++dc) {
+                int newCol = col + dc;
+                if (newCol >= 0 && newCol < cols && parent[index - cols + dc] >= 0) {
+                    Union(index, index - cols + dc);
+                }
+            }
+        }
+    }
+
+    // Every root is the lowest cell of its opening, so numbering roots as they are met
+    // in row-major order numbers each opening before any of its other cells is reached
+    for (int i = 0; i < cellCount; ++i) {
+        if (parent[i] < 0) {
+            continue;
+        }
+        int root = Find(i);
+        if (root == i) {
+            openingOf[i] = (int)zeroCount.size();
+            zeroCount.push_back(0);
+            touchedCount.push_back(0);
+        }
+        int opening = openingOf[root];
+        openingOf[i] = opening;
+        zeroCount[opening]++;
+        if (board.AtIndex(i).state != CellState::HIDDEN) {
+            touchedCount[opening]++;
+        }
+    }
+    parent.clear();
+    parent.shrink_to_fit();
+
+    // A cell belongs to the reveal set of every opening that has a zero cell in its 3x3
+    // neighbourhood. Spans never cross rows, so each stripe collects its own in row-major
+    // order, and the stripes are then concatenated per opening. This stays a pass of its own
+    // rather than riding along with the numbering above: that pass is serial, and a row's
+    // spans need the row below numbered, while on its own it splits into parallel stripes.
+    std::vector<std::vector<int>> stripeOpenings(stripeCount);
+    std::vector<std::vector<CellSpan>> stripeSpans(stripeCount);
+    ParallelFor(stripeCount, [&](int stripe) {
+        std::vector<int>& spanOpenings = stripeOpenings[stripe];
+        std::vector<CellSpan>& rowSpans = stripeSpans[stripe];
+        int rowEnd = std::min(rows, (stripe + 1) * STRIPE_ROWS);
+        for (int row = stripe * STRIPE_ROWS; row < rowEnd; ++row) {
+            // Openings of the previous column, with the span each one is extending
+            int previous[9];
+            int previousSpans[9];
+            int previousFound = 0;
+            for (int col = 0; col < cols; ++col) {
+                int openings[9];
+                int openingSpans[9];
+                int openingsFound = 0;
+                for (int dr = -1; dr <= 1; ++dr) {
+                    for (int dc = -1; dc <= 1; ++dc) {
+                        int newRow = row + dr;
+                        int newCol = col + dc;
+                        if (newRow < 0 || newRow >= rows || newCol < 0 || newCol >= cols) {
+                            continue;
+                        }
+                        int opening = openingOf[newRow * cols + newCol];
+                        if (opening >= 0 &&
+                            std::find(openings, openings + openingsFound, opening) == openings + openingsFound) {
+                            openings[openingsFound++] = opening;
+                        }
+                    }
+                }
+
+                for (int i = 0; i < openingsFound; ++i) {
+                    int* found = std::find(previous, previous + previousFound, openings[i]);
+                    if (found != previous + previousFound) {
+                        // Extend the opening's current span
+                        openingSpans[i] = previousSpans[found - previous];
+                        rowSpans[openingSpans[i]].colEnd = col + 1;
+                    } else {
+                        openingSpans[i] = (int)rowSpans.size();
+                        spanOpenings.push_back(openings[i]);
+                        rowSpans.push_back({ row, col, col + 1 });
+                    }
+                }
+                std::copy(openings, openings + openingsFound, previous);
+                std::copy(openingSpans, openingSpans + openingsFound, previousSpans);
+                previousFound = openingsFound;
+            }
+        }
+    });
+
+    int openingCount = OpeningCount();
+    spanStart.assign(openingCount + 1, 0);
+    for (const std::vector<int>& spanOpenings : stripeOpenings) {
+        for (int opening : spanOpenings) {
+            spanStart[opening + 1]++;
+        }
+    }
+    for (int i = 0; i < openingCount; ++i) {
+        spanStart[i + 1] += spanStart[i];
+    }
+    spans.resize(spanStart[openingCount]);
+    std::vector<int> cursor(spanStart.begin(), spanStart.end() - 1);
+    for (int stripe = 0; stripe < stripeCount; ++stripe) {
+        for (size_t i = 0; i < stripeOpenings[stripe].size(); ++i) {
+            spans[cursor[stripeOpenings[stripe][i]]++] = stripeSpans[stripe][i];
+        }
+    }
+}
+
+void OpeningIndex::Union(int a, int b) {
+    a = Find(a);
+    b = Find(b);
+    if (a != b) {
+        parent[std::max(a, b)] = std::min(a, b);
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+class Board;
+
+// Cells [colBegin, colEnd) of one row
+struct CellSpan {
+    int row;
+    int colBegin;
+    int colEnd;
+};
+
+// Every opening (8-connected region of cells with no adjacent mines) labelled at generation
+// time, with its full reveal set - the zero cells plus their numbered border - stored as
+// row spans. Revealing an untouched opening is then a bulk apply of its spans.
+// Build() is linear in the cell count but takes several passes: union-find labelling (in
+// parallel stripes), a row-major pass numbering the openings, span collection (in parallel
+// stripes again) and a counting sort of the spans by opening.
+class OpeningIndex
+{
+public:
+    OpeningIndex();
+
+    void Build(const Board& board);
+    void Clear();
+
+    int OpeningCount() const { return (int)zeroCount.size(); }
+    int OpeningOf(int cellIndex) const { return openingOf.empty() ? -1 : openingOf[cellIndex]; }
+    const CellSpan* SpansBegin(int opening) const { return spans.data() + spanStart[opening]; }
+    const CellSpan* SpansEnd(int opening) const { return spans.data() + spanStart[opening + 1]; }
+
+    // An opening's spans match a cascade only while none of its zero cells have been
+    // revealed or flagged; the board reports every zero cell that leaves or re-enters HIDDEN.
+    bool IsUntouched(int opening) const { return touchedCount[opening] == 0; }
+    void MarkTouched(int opening) { touchedCount[opening]++; }
+    void MarkUntouched(int opening) { touchedCount[opening]--; }
+    void MarkFullyRevealed(int opening) { touchedCount[opening] = zeroCount[opening]; }
+
+private:
+    int Find(int label);
+    void Union(int a, int b);  // Joins the labels of two zero cells; the root is always the lower cell
+
+    std::vector<int> openingOf;     // Opening of each zero cell, -1 for every other cell
+    std::vector<int> spanStart;     // Spans of opening i are spans[spanStart[i] .. spanStart[i + 1])
+    std::vector<CellSpan> spans;
+    std::vector<int> zeroCount;     // Zero cells per opening
+    std::vector<int> touchedCount;  // Zero cells per opening that are not HIDDEN
+
+    std::vector<int> parent;        // Per cell union-find parent while labelling, -1 for non-zero cells
+};
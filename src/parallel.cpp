@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#ifndef __EMSCRIPTEN__
+#include <thread>
+#endif
+
+#include "parallel.h"
+
+int WorkerCount() {
+#ifdef __EMSCRIPTEN__
+    return 1;
+#else
+    static const int workers = (int)std::max(1u, std::thread::hardware_concurrency());
+    return workers;
+#endif
+}
+
+void ParallelFor(int count, const std::function<void(int)>& task) {
+#ifdef __EMSCRIPTEN__
+    for (int i = 0; i < count; ++i) {
+        task(i);
+    }
+#else
+    unsigned int workerCount = (unsigned int)std::min(WorkerCount(), std::max(count, 0));
+    if (workerCount <= 1) {
+        for (int i = 0; i < count; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        for (int i = next++; i < count; i = next++) {
+            task(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned int i = 1; i < workerCount; ++i) {
+        workers.emplace_back(work);
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+#endif
+}
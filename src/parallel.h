@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#ifndef __EMSCRIPTEN__
+#include <chrono>
+#include <future>
+#endif
+
+// Runs task(0) .. task(count - 1) on every hardware thread, the calling thread included.
+// Tasks are handed out in order from a shared counter, so uneven tasks balance themselves.
+// Runs inline when there is only one task, one core, or no threads (the web build).
+void ParallelFor(int count, const std::function<void(int)>& task);
+
+// Threads ParallelFor would use; 1 when parallel work would only add overhead
+int WorkerCount();
+
+// Runs one job at a time off the calling thread, for work that must not hold up a frame:
+// Start() it, poll Ready() once a frame and Take() the result. Destroying a busy task waits
+// for its job. The web build has no threads, so there the job runs inside Start().
+template <typename T>
+class BackgroundTask
+{
+public:
+    bool Started() const {  // Started and not yet taken
+#ifdef __EMSCRIPTEN__
+        return value != nullptr;
+#else
+        return result.valid();
+#endif
+    }
+    bool Busy() const { return Started() && !Ready(); }
+    bool Ready() const {
+#ifdef __EMSCRIPTEN__
+        return value != nullptr;
+#else
+        return result.valid() && result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+#endif
+    }
+
+    // Returns false, without starting job, while the previous one is still busy
+    bool Start(std::function<T()> job) {
+        if (Busy()) {
+            return false;
+        }
+#ifdef __EMSCRIPTEN__
+        value.reset(new T(job()));
+#else
+        result = std::async(std::launch::async, std::move(job));
+#endif
+        return true;
+    }
+
+    // The job's result, waiting for it to finish if it is still busy; only valid once Started()
+    T Take() {
+#ifdef __EMSCRIPTEN__
+        T taken = std::move(*value);
+        value.reset();
+        return taken;
+#else
+        return result.get();
+#endif
+    }
+
+private:
+#ifdef __EMSCRIPTEN__
+    std::unique_ptr<T> value;
+#else
+    std::future<T> result;
+#endif
+};
+
+// Grids are split into stripes of whole rows for parallel work; a stripe's results must not
+// depend on any other stripe's, so they don't depend on the thread count either
+const int STRIPE_ROWS = 64;
+inline int StripeCount(int rows) { return (rows + STRIPE_ROWS - 1) / STRIPE_ROWS; }
+
+// One bit per cell that threads can claim without locks. Bits are set during one parallel
+// operation and cleared before it returns, so a copy only needs to be a clear set of the
+// same size.
+class AtomicBitset
+{
+public:
+    AtomicBitset() : bitCount(0) {}
+    AtomicBitset(const AtomicBitset& other) : bitCount(0) { Resize(other.bitCount); }
+    AtomicBitset& operator=(const AtomicBitset& other) { Resize(other.bitCount); return *this; }
+
+    void Resize(int count) {
+        if (count == bitCount) return;
+        bitCount = count;
+        int wordCount = (count + 63) / 64;
+        words.reset(new std::atomic<uint64_t>[wordCount]);
+        for (int i = 0; i < wordCount; ++i) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // True if this call set the bit, false if it was already set
+    bool Claim(int index) {
+        uint64_t bit = 1ULL << (index & 63);
+        std::atomic<uint64_t>& word = words[index >> 6];
+        // A plain load first skips the locked write for bits that are already set
+        return (word.load(std::memory_order_relaxed) & bit) == 0 &&
+               (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    }
+    void ClearWordOf(int index) { words[index >> 6].store(0, std::memory_order_relaxed); }
+
+private:
+    int bitCount;
+    std::unique_ptr<std::atomic<uint64_t>[]> words;
+};
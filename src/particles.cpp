@@ -0,0 +1,112 @@
+#include <cmath>
+
+#include "particles.h"
+
+namespace {
+    const float TWO_PI = 6.28318530718f;
+    const float SPARK_LIFETIME = 0.6f;       // Shortest spark, in seconds; the longest is twice that
+    const float CONFETTI_LIFETIME = 2.0f;
+    const float CONFETTI_SPIN = 12.0f;       // Fastest spin, radians per second
+
+    // One pass of straight-line float arithmetic over separate arrays: no branches, and the
+    // restrict parameters promise no aliasing, so it compiles to packed SIMD
+    void Integrate(float* __restrict x, float* __restrict y, float* __restrict vx, float* __restrict vy,
+                   float* __restrict life, float* __restrict angle, const float* __restrict spin, int count,
+                   float dt, float damping, float fall) {
+        for (int i = 0; i < count; ++i) {
+            vx[i] *= damping;
+            vy[i] = vy[i] * damping + fall;
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            angle[i] += spin[i] * dt;
+            life[i] -= dt;
+        }
+    }
+}
+
+const int ParticlePool::CAPACITY;
+
+ParticlePool::ParticlePool()
+    : count(0), rngState(0x9e3779b9u),
+      x(CAPACITY), y(CAPACITY), vx(CAPACITY), vy(CAPACITY), life(CAPACITY), inverseLifetime(CAPACITY),
+      size(CAPACITY), angle(CAPACITY), spin(CAPACITY), color(CAPACITY), kind(CAPACITY)
+{
+}
+
+float ParticlePool::Random() {
+    // xorshift32 is plenty for effects and keeps emitting allocation- and lock-free
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return (rngState >> 8) * (1.0f / 16777216.0f);
+}
+
+void ParticlePool::Emit(float px, float py, float pvx, float pvy, float lifetime, float psize, float pspin,
+                        uint32_t pcolor, ParticleKind pkind) {
+    if (count == CAPACITY) {
+        return;
+    }
+    x[count] = px;
+    y[count] = py;
+    vx[count] = pvx;
+    vy[count] = pvy;
+    life[count] = lifetime;
+    inverseLifetime[count] = 1.0f / lifetime;
+    size[count] = psize;
+    angle[count] = Random() * TWO_PI;
+    spin[count] = pspin;
+    color[count] = pcolor;
+    kind[count] = pkind;
+    count++;
+}
+
+void ParticlePool::EmitBurst(float px, float py, int n, float speed, float psize, const uint32_t* palette, int paletteSize) {
+    for (int i = 0; i < n && count < CAPACITY; ++i) {
+        // Square root of the radius keeps the burst evenly filled rather than bunched in the middle
+        float direction = Random() * TWO_PI;
+        float velocity = speed * std::sqrt(Random());
+        Emit(px, py, velocity * std::cos(direction), velocity * std::sin(direction),
+             SPARK_LIFETIME * (1.0f + Random()), psize * (0.5f + Random()), 0.0f,
+             palette[(int)(Random() * paletteSize)], ParticleKind::SPARK);
+    }
+}
+
+void ParticlePool::EmitConfetti(float left, float width, float py, int n, float speed, float psize,
+                                const uint32_t* palette, int paletteSize) {
+    for (int i = 0; i < n && count < CAPACITY; ++i) {
+        // Thrown up and slightly outwards, within 30 degrees of vertical
+        float direction = (Random() - 0.5f) * (TWO_PI / 6.0f);
+        float velocity = speed * (0.6f + 0.4f * Random());
+        Emit(left + Random() * width, py, velocity * std::sin(direction), -velocity * std::cos(direction),
+             CONFETTI_LIFETIME * (0.75f + 0.5f * Random()), psize * (0.75f + 0.5f * Random()),
+             (Random() * 2.0f - 1.0f) * CONFETTI_SPIN, palette[(int)(Random() * paletteSize)], ParticleKind::CONFETTI);
+    }
+}
+
+void ParticlePool::Update(float dt, float gravity, float drag) {
+    Integrate(x.data(), y.data(), vx.data(), vy.data(), life.data(), angle.data(), spin.data(), count,
+              dt, std::exp(-drag * dt), gravity * dt);
+
+    // Compact the survivors to the front, keeping their order
+    int alive = 0;
+    for (int i = 0; i < count; ++i) {
+        if (life[i] <= 0.0f) {
+            continue;
+        }
+        if (alive != i) {
+            x[alive] = x[i];
+            y[alive] = y[i];
+            vx[alive] = vx[i];
+            vy[alive] = vy[i];
+            life[alive] = life[i];
+            inverseLifetime[alive] = inverseLifetime[i];
+            size[alive] = size[i];
+            angle[alive] = angle[i];
+            spin[alive] = spin[i];
+            color[alive] = color[i];
+            kind[alive] = kind[i];
+        }
+        alive++;
+    }
+    count = alive;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Kinds of particle, one sprite each in the game's particle atlas
+enum class ParticleKind : uint8_t {
+    SPARK,      // Round glow, explosions
+    CONFETTI    // Spinning rectangle, wins
+};
+
+// Fixed-capacity particle pool for the loss and win effects. Every field is its own array,
+// so Update() is a branch-free loop over plain floats that the compiler vectorizes, and
+// dead particles are compacted away afterwards. All storage is allocated by the constructor;
+// emitting into a full pool drops the extra particles rather than growing.
+class ParticlePool
+{
+public:
+    static const int CAPACITY = 16384;
+
+    ParticlePool();
+
+    void Clear() { count = 0; }
+    int Count() const { return count; }
+    bool Empty() const { return count == 0; }
+
+    // count sparks flying out of (x, y) at up to speed pixels/s, colors picked from palette
+    // (RGBA words, red in the low byte)
+    void EmitBurst(float x, float y, int count, float speed, float size, const uint32_t* palette, int paletteSize);
+    // count pieces of confetti thrown up from the span [left, left + width) along y
+    void EmitConfetti(float left, float width, float y, int count, float speed, float size,
+                      const uint32_t* palette, int paletteSize);
+
+    // Moves every particle dt seconds on, under gravity (pixels/s^2) and drag (1/s)
+    void Update(float dt, float gravity, float drag);
+
+    // Read-only views of the arrays for drawing, Count() entries each
+    const float* X() const { return x.data(); }
+    const float* Y() const { return y.data(); }
+    const float* Size() const { return size.data(); }
+    const float* Angle() const { return angle.data(); }  // Radians
+    float Fade(int i) const { return life[i] * inverseLifetime[i]; }  // 1 when born, 0 at death
+    uint32_t Color(int i) const { return color[i]; }
+    ParticleKind Kind(int i) const { return kind[i]; }
+
+private:
+    void Emit(float x, float y, float vx, float vy, float lifetime, float size, float spin, uint32_t color, ParticleKind kind);
+    float Random();  // Uniform in [0, 1)
+
+    int count;
+    uint32_t rngState;
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> vx;
+    std::vector<float> vy;
+    std::vector<float> life;             // Seconds left
+    std::vector<float> inverseLifetime;
+    std::vector<float> size;
+    std::vector<float> angle;
+    std::vector<float> spin;             // Radians per second
+    std::vector<uint32_t> color;
+    std::vector<ParticleKind> kind;
+};
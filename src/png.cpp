@@ -0,0 +1,590 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+#include "png.h"
+
+namespace {
+    const uint8_t PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+
+    // Deflate length and distance codes (RFC 1951, 3.2.5)
+    const int LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                  35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    const int LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                   3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    const int DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                    8193, 12289, 16385, 24577 };
+    const int DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                     7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    const int WINDOW_SIZE = 32768;
+    const int HASH_BITS = 15;
+    const int MIN_MATCH = 3;
+    const int MAX_MATCH = 258;
+    const int MAX_CHAIN = 32;  // Match candidates tried per position
+    const int MAX_INSERT = 32; // Longest match whose every position goes into the hash chains
+
+    uint32_t Crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+        struct Table {
+            uint32_t entries[256];
+            Table() {
+                for (uint32_t n = 0; n < 256; ++n) {
+                    uint32_t c = n;
+                    for (int k = 0; k < 8; ++k) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                    entries[n] = c;
+                }
+            }
+        };
+        static const Table table;
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    uint32_t Adler32(const uint8_t* data, size_t size) {
+        uint32_t a = 1;
+        uint32_t b = 0;
+        while (size > 0) {
+            size_t block = std::min(size, (size_t)5552);  // Largest run without overflowing b
+            for (size_t i = 0; i < block; ++i) {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+            data += block;
+            size -= block;
+        }
+        return (b << 16) | a;
+    }
+
+    void PutBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(value >> shift));
+    }
+
+    uint32_t ReadBigEndian(const uint8_t* bytes) {
+        return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3];
+    }
+
+    // Length of the common prefix, compared a word at a time (the first differing byte of a
+    // little-endian word is its lowest set byte)
+    int MatchLength(const uint8_t* a, const uint8_t* b, int limit) {
+        int length = 0;
+        while (length + 8 <= limit) {
+            uint64_t wordA;
+            uint64_t wordB;
+            std::memcpy(&wordA, a + length, 8);
+            std::memcpy(&wordB, b + length, 8);
+            if (wordA != wordB) {
+                return length + (__builtin_ctzll(wordA ^ wordB) >> 3);
+            }
+            length += 8;
+        }
+        while (length < limit && a[length] == b[length]) length++;
+        return length;
+    }
+
+    int Paeth(int left, int up, int upLeft) {
+        int estimate = left + up - upLeft;
+        int dLeft = std::abs(estimate - left);
+        int dUp = std::abs(estimate - up);
+        int dUpLeft = std::abs(estimate - upLeft);
+        if (dLeft <= dUp && dLeft <= dUpLeft) return left;
+        return dUp <= dUpLeft ? up : upLeft;
+    }
+
+    // Inflate (RFC 1950/1951), enough for PNG image data
+    class Inflater
+    {
+    public:
+        Inflater(const uint8_t* data, size_t size) : data(data), size(size), pos(0), bits(0), bitCount(0), error(false) {}
+
+        bool Run(std::vector<uint8_t>& out) {
+            if (size < 2 || (data[0] & 0x0f) != 8 || ((data[0] << 8) | data[1]) % 31 != 0) {
+                return false;
+            }
+            pos = 2;
+            bool last = false;
+            while (!last && !error) {
+                last = Bits(1) != 0;
+                int type = Bits(2);
+                if (type == 0) {
+                    Stored(out);
+                } else if (type == 1) {
+                    Fixed(out);
+                } else if (type == 2) {
+                    Dynamic(out);
+                } else {
+                    return false;
+                }
+            }
+            return !error;
+        }
+
+    private:
+        struct Huffman {
+            int16_t counts[16];
+            int16_t symbols[288];
+        };
+
+        int Bits(int count) {
+            while (bitCount < count) {
+                if (pos >= size) {
+                    error = true;
+                    return 0;
+                }
+                bits |= (uint32_t)data[pos++] << bitCount;
+                bitCount += 8;
+            }
+            int value = (int)(bits & ((1u << count) - 1));
+            bits >>= count;
+            bitCount -= count;
+            return value;
+        }
+
+        static bool Build(Huffman& code, const uint8_t* lengths, int count) {
+            std::fill(std::begin(code.counts), std::end(code.counts), 0);
+            for (int symbol = 0; symbol < count; ++symbol) code.counts[lengths[symbol]]++;
+            int offsets[16];
+            offsets[1] = 0;
+            int left = 1;
+            for (int length = 1; length < 16; ++length) {
+                left = (left << 1) - code.counts[length];
+                if (left < 0) return false;  // Oversubscribed
+                if (length < 15) offsets[length + 1] = offsets[length] + code.counts[length];
+            }
+            for (int symbol = 0; symbol < count; ++symbol) {
+                if (lengths[symbol] != 0) code.symbols[offsets[lengths[symbol]]++] = (int16_t)symbol;
+            }
+            return true;
+        }
+
+        int Decode(const Huffman& code) {
+            int value = 0;
+            int first = 0;
+            int index = 0;
+            for (int length = 1; length < 16; ++length) {
+                value |= Bits(1);
+                int count = code.counts[length];
+                if (value - first < count) return code.symbols[index + value - first];
+                index += count;
+                first = (first + count) << 1;
+                value <<= 1;
+            }
+            error = true;
+            return 0;
+        }
+
+        void Stored(std::vector<uint8_t>& out) {
+            bits = 0;  // Skip to the byte boundary
+            bitCount = 0;
+            if (pos + 4 > size) {
+                error = true;
+                return;
+            }
+            size_t length = data[pos] | (data[pos + 1] << 8);
+            pos += 4;
+            if (pos + length > size) {
+                error = true;
+                return;
+            }
+            out.insert(out.end(), data + pos, data + pos + length);
+            pos += length;
+        }
+
+        void Fixed(std::vector<uint8_t>& out) {
+            static const struct FixedCodes {
+                Huffman lengths;
+                Huffman distances;
+                FixedCodes() {
+                    uint8_t sizes[288];
+                    for (int symbol = 0; symbol < 288; ++symbol) {
+                        sizes[symbol] = symbol < 144 ? 8 : symbol < 256 ? 9 : symbol < 280 ? 7 : 8;
+                    }
+                    Build(lengths, sizes, 288);
+                    std::fill(sizes, sizes + 30, 5);
+                    Build(distances, sizes, 30);
+                }
+            } codes;
+            Codes(out, codes.lengths, codes.distances);
+        }
+
+        void Dynamic(std::vector<uint8_t>& out) {
+            static const int ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+            int lengthCount = Bits(5) + 257;
+            int distanceCount = Bits(5) + 1;
+            int codeCount = Bits(4) + 4;
+            if (lengthCount > 286 || distanceCount > 30) {
+                error = true;
+                return;
+            }
+            uint8_t sizes[320] = {};
+            for (int i = 0; i < codeCount; ++i) sizes[ORDER[i]] = (uint8_t)Bits(3);
+            Huffman codeLengths;
+            if (!Build(codeLengths, sizes, 19)) {
+                error = true;
+                return;
+            }
+
+            std::fill(sizes, sizes + 19, 0);
+            int index = 0;
+            while (index < lengthCount + distanceCount && !error) {
+                int symbol = Decode(codeLengths);
+                if (symbol < 16) {
+                    sizes[index++] = (uint8_t)symbol;
+                    continue;
+                }
+                int repeat;
+                uint8_t value = 0;
+                if (symbol == 16) {
+                    if (index == 0) {
+                        error = true;
+                        return;
+                    }
+                    value = sizes[index - 1];
+                    repeat = 3 + Bits(2);
+                } else if (symbol == 17) {
+                    repeat = 3 + Bits(3);
+                } else {
+                    repeat = 11 + Bits(7);
+                }
+                if (index + repeat > lengthCount + distanceCount) {
+                    error = true;
+                    return;
+                }
+                while (repeat-- > 0) sizes[index++] = value;
+            }
+
+            Huffman lengths;
+            Huffman distances;
+            if (error || !Build(lengths, sizes, lengthCount) || !Build(distances, sizes + lengthCount, distanceCount)) {
+                error = true;
+                return;
+            }
+            Codes(out, lengths, distances);
+        }
+
+        void Codes(std::vector<uint8_t>& out, const Huffman& lengths, const Huffman& distances) {
+            while (!error) {
+                int symbol = Decode(lengths);
+                if (symbol < 256) {
+                    out.push_back((uint8_t)symbol);
+                    continue;
+                }
+                if (symbol == 256) {
+                    return;
+                }
+                symbol -= 257;
+                if (symbol >= 29) {
+                    error = true;
+                    return;
+                }
+                int length = LENGTH_BASE[symbol] + Bits(LENGTH_EXTRA[symbol]);
+                int distanceSymbol = Decode(distances);
+                if (distanceSymbol >= 30) {
+                    error = true;
+                    return;
+                }
+                size_t distance = DISTANCE_BASE[distanceSymbol] + Bits(DISTANCE_EXTRA[distanceSymbol]);
+                if (distance > out.size()) {
+                    error = true;
+                    return;
+                }
+                size_t from = out.size() - distance;
+                for (int i = 0; i < length; ++i) out.push_back(out[from + i]);
+            }
+        }
+
+        const uint8_t* data;
+        size_t size;
+        size_t pos;
+        uint32_t bits;
+        int bitCount;
+        bool error;
+    };
+}
+
+bool LoadPng(const std::string& filename, RgbaImage& image) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+#ifdef DEBUG
+        std::cerr << "Failed to open PNG: " << filename << std::endl;
+#endif
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 8 || std::memcmp(bytes.data(), PNG_SIGNATURE, 8) != 0) {
+        return false;
+    }
+
+    // Gather the header and the image data, which may be split over several IDAT chunks
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<uint8_t> zlibData;
+    size_t pos = 8;
+    while (pos + 12 <= bytes.size()) {
+        uint32_t length = ReadBigEndian(&bytes[pos]);
+        const uint8_t* type = &bytes[pos + 4];
+        const uint8_t* body = &bytes[pos + 8];
+        if (length > bytes.size() - pos - 12) {
+            return false;
+        }
+        if (std::memcmp(type, "IHDR", 4) == 0 && length >= 13) {
+            width = (int)ReadBigEndian(body);
+            height = (int)ReadBigEndian(body + 4);
+            int bitDepth = body[8];
+            int colorType = body[9];
+            int interlace = body[12];
+            static const int CHANNELS[7] = { 1, 0, 3, 0, 2, 0, 4 };
+            channels = colorType <= 6 ? CHANNELS[colorType] : 0;
+            if (bitDepth != 8 || interlace != 0 || channels == 0 || width <= 0 || height <= 0) {
+                return false;
+            }
+        } else if (std::memcmp(type, "IDAT", 4) == 0) {
+            zlibData.insert(zlibData.end(), body, body + length);
+        } else if (std::memcmp(type, "IEND", 4) == 0) {
+            break;
+        }
+        pos += 12 + length;
+    }
+    if (channels == 0) {
+        return false;
+    }
+
+    size_t stride = (size_t)width * channels;
+    std::vector<uint8_t> raw;
+    raw.reserve((stride + 1) * height);
+    if (!Inflater(zlibData.data(), zlibData.size()).Run(raw) || raw.size() < (stride + 1) * height) {
+        return false;
+    }
+
+    // Undo the row filters in place, then widen to RGBA
+    for (int y = 0; y < height; ++y) {
+        uint8_t filter = raw[y * (stride + 1)];
+        uint8_t* row = &raw[y * (stride + 1) + 1];
+        const uint8_t* up = y > 0 ? row - (stride + 1) : nullptr;
+        for (size_t i = 0; i < stride; ++i) {
+            int left = i >= (size_t)channels ? row[i - channels] : 0;
+            int above = up ? up[i] : 0;
+            int aboveLeft = up && i >= (size_t)channels ? up[i - channels] : 0;
+            switch (filter) {
+                case 0: break;
+                case 1: row[i] = (uint8_t)(row[i] + left); break;
+                case 2: row[i] = (uint8_t)(row[i] + above); break;
+                case 3: row[i] = (uint8_t)(row[i] + ((left + above) >> 1)); break;
+                case 4: row[i] = (uint8_t)(row[i] + Paeth(left, above, aboveLeft)); break;
+                default: return false;
+            }
+        }
+    }
+
+    image.Resize(width, height);
+    uint8_t* out = reinterpret_cast<uint8_t*>(image.pixels.data());
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = &raw[y * (stride + 1) + 1];
+        for (int x = 0; x < width; ++x, out += 4, row += channels) {
+            bool grey = channels <= 2;
+            out[0] = row[0];
+            out[1] = grey ? row[0] : row[1];
+            out[2] = grey ? row[0] : row[2];
+            out[3] = channels == 2 ? row[1] : channels == 4 ? row[3] : 255;
+        }
+    }
+    return true;
+}
+
+void PngEncoder::PutBits(uint32_t value, int count) {
+    bitBuffer |= value << bitCount;
+    bitCount += count;
+    while (bitCount >= 8) {
+        compressed.push_back((uint8_t)bitBuffer);
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+void PngEncoder::PutHuffman(uint32_t code, int length) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    PutBits(reversed, length);
+}
+
+void PngEncoder::PutLiteral(int symbol) {
+    // The fixed literal/length code (RFC 1951, 3.2.6)
+    if (symbol < 144) PutHuffman(0x30 + symbol, 8);
+    else if (symbol < 256) PutHuffman(0x190 + symbol - 144, 9);
+    else if (symbol < 280) PutHuffman(symbol - 256, 7);
+    else PutHuffman(0xc0 + symbol - 280, 8);
+}
+
+void PngEncoder::PutMatch(int length, int distance) {
+    int lengthSymbol = (int)(std::upper_bound(LENGTH_BASE, LENGTH_BASE + 29, length) - LENGTH_BASE) - 1;
+    PutLiteral(257 + lengthSymbol);
+    PutBits(length - LENGTH_BASE[lengthSymbol], LENGTH_EXTRA[lengthSymbol]);
+    int distanceSymbol = (int)(std::upper_bound(DISTANCE_BASE, DISTANCE_BASE + 30, distance) - DISTANCE_BASE) - 1;
+    PutHuffman(distanceSymbol, 5);
+    PutBits(distance - DISTANCE_BASE[distanceSymbol], DISTANCE_EXTRA[distanceSymbol]);
+}
+
+void PngEncoder::Deflate(const std::vector<uint8_t>& data) {
+    compressed.clear();
+    bitBuffer = 0;
+    bitCount = 0;
+    compressed.push_back(0x78);  // zlib header: deflate, 32K window, no preset dictionary
+    compressed.push_back(0x01);
+    PutBits(1, 1);  // One final block with the fixed codes
+    PutBits(1, 2);
+
+    // Greedy LZ77 over hash chains of 3-byte prefixes
+    head.assign(1 << HASH_BITS, -1);
+    previous.assign(WINDOW_SIZE, -1);
+    int size = (int)data.size();
+    auto hash = [&](int pos) {
+        uint32_t key = data[pos] | (data[pos + 1] << 8) | (data[pos + 2] << 16);
+        return (int)((key * 2654435761u) >> (32 - HASH_BITS));
+    };
+    auto insert = [&](int pos) {
+        if (pos + MIN_MATCH <= size) {
+            int key = hash(pos);
+            previous[pos & (WINDOW_SIZE - 1)] = head[key];
+            head[key] = pos;
+        }
+    };
+
+    int pos = 0;
+    while (pos < size) {
+        int bestLength = 0;
+        int bestDistance = 0;
+        if (pos + MIN_MATCH <= size) {
+            int limit = std::min(MAX_MATCH, size - pos);
+            int candidate = head[hash(pos)];
+            for (int chain = 0; chain < MAX_CHAIN && candidate >= 0 && pos - candidate <= WINDOW_SIZE; ++chain) {
+                if (data[candidate + bestLength] == data[pos + bestLength]) {
+                    int length = MatchLength(&data[candidate], &data[pos], limit);
+                    if (length > bestLength) {
+                        bestLength = length;
+                        bestDistance = pos - candidate;
+                        if (length == limit) break;
+                    }
+                }
+                candidate = previous[candidate & (WINDOW_SIZE - 1)];
+            }
+        }
+
+        if (bestLength >= MIN_MATCH) {
+            // Like zlib's faster levels, long matches only index their start and end
+            PutMatch(bestLength, bestDistance);
+            if (bestLength <= MAX_INSERT) {
+                for (int i = 0; i < bestLength; ++i) insert(pos + i);
+            } else {
+                insert(pos);
+                insert(pos + bestLength - 1);
+            }
+            pos += bestLength;
+        } else {
+            PutLiteral(data[pos]);
+            insert(pos);
+            pos++;
+        }
+    }
+    PutLiteral(256);  // End of block
+    if (bitCount > 0) {
+        PutBits(0, 8 - bitCount);
+    }
+    PutBigEndian(compressed, Adler32(data.data(), data.size()));
+}
+
+void PngEncoder::AddChunk(const char* type, const uint8_t* data, size_t size) {
+    PutBigEndian(output, (uint32_t)size);
+    size_t start = output.size();
+    output.insert(output.end(), type, type + 4);
+    output.insert(output.end(), data, data + size);
+    PutBigEndian(output, Crc32(&output[start], output.size() - start));
+}
+
+const std::vector<uint8_t>& PngEncoder::Encode(const RgbaImage& image) {
+    // Filter each row with whichever of None, Sub, Up and Paeth gives the smallest residuals,
+    // summed as signed bytes
+    size_t stride = (size_t)image.width * 4;
+    filtered.resize((stride + 1) * image.height);
+    candidate.resize(stride * 4);
+    const uint8_t* pixels = reinterpret_cast<const uint8_t*>(image.pixels.data());
+    auto cost = [stride](const uint8_t* bytes) {
+        long sum = 0;
+        for (size_t i = 0; i < stride; ++i) sum += std::abs((int)(int8_t)bytes[i]);
+        return sum;
+    };
+    for (int y = 0; y < image.height; ++y) {
+        const uint8_t* row = pixels + y * stride;
+        const uint8_t* above = y > 0 ? row - stride : nullptr;
+        size_t head = std::min(stride, (size_t)4);
+
+        // Filters are tried cheapest first and the search stops at a row of zeros; identical
+        // rows, common in rendered boards, make Up all zeros
+        static const uint8_t ORDER[4] = { 2, 1, 0, 4 };
+        long bestScore = -1;
+        int best = 0;
+        for (int i = 0; i < 4 && bestScore != 0; ++i) {
+            uint8_t filter = ORDER[i];
+            uint8_t* out = &candidate[i * stride];
+            if (filter == 0 || (filter == 2 && !above)) {
+                std::memcpy(out, row, stride);
+            } else if (filter == 2) {
+                for (size_t x = 0; x < stride; ++x) out[x] = (uint8_t)(row[x] - above[x]);
+            } else if (filter == 1 || !above) {
+                std::memcpy(out, row, head);
+                for (size_t x = 4; x < stride; ++x) out[x] = (uint8_t)(row[x] - row[x - 4]);
+            } else {
+                for (size_t x = 0; x < head; ++x) out[x] = (uint8_t)(row[x] - above[x]);
+                for (size_t x = 4; x < stride; ++x) out[x] = (uint8_t)(row[x] - Paeth(row[x - 4], above[x], above[x - 4]));
+            }
+            long score = cost(out);
+            if (bestScore < 0 || score < bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+        filtered[y * (stride + 1)] = ORDER[best];
+        std::memcpy(&filtered[y * (stride + 1) + 1], &candidate[best * stride], stride);
+    }
+    Deflate(filtered);
+
+    output.clear();
+    output.insert(output.end(), PNG_SIGNATURE, PNG_SIGNATURE + 8);
+    uint8_t header[13];
+    for (int i = 0; i < 4; ++i) {
+        header[i] = (uint8_t)(image.width >> (24 - 8 * i));
+        header[4 + i] = (uint8_t)(image.height >> (24 - 8 * i));
+    }
+    header[8] = 8;   // Bits per channel
+    header[9] = 6;   // RGBA
+    header[10] = 0;  // Deflate
+    header[11] = 0;  // Adaptive filtering
+    header[12] = 0;  // Not interlaced
+    AddChunk("IHDR", header, sizeof(header));
+    AddChunk("IDAT", compressed.data(), compressed.size());
+    AddChunk("IEND", nullptr, 0);
+    return output;
+}
+
+bool PngEncoder::Save(const RgbaImage& image, const std::string& filename) {
+    const std::vector<uint8_t>& data = Encode(image);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+#ifdef DEBUG
+        std::cerr << "Failed to open PNG for saving: " << filename << std::endl;
+#endif
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// 8-bit RGBA pixels, row-major; each pixel is R, G, B, A in memory order
+struct RgbaImage {
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;
+
+    RgbaImage() : width(0), height(0) {}
+    void Resize(int width, int height) {
+        this->width = width;
+        this->height = height;
+        pixels.resize((size_t)width * height);
+    }
+};
+
+// Reads 8-bit grey, grey-alpha, RGB and RGBA PNGs without interlacing, which covers the
+// sprites in data/. Returns false for anything else.
+bool LoadPng(const std::string& filename, RgbaImage& image);
+
+// Writes RGBA PNGs with no library and no GPU. Every row gets the filter that leaves the
+// smallest residuals, and the stream is deflated with LZ77 and the fixed Huffman codes,
+// which suits the flat colors and repeated tiles of rendered boards. All buffers are kept
+// between images, so use one encoder per thread.
+class PngEncoder
+{
+public:
+    const std::vector<uint8_t>& Encode(const RgbaImage& image);
+    bool Save(const RgbaImage& image, const std::string& filename);
+
+private:
+    void Deflate(const std::vector<uint8_t>& data);
+    void PutBits(uint32_t bits, int count);
+    void PutHuffman(uint32_t code, int length);  // Huffman codes go most significant bit first
+    void PutLiteral(int literal);
+    void PutMatch(int length, int distance);
+    void AddChunk(const char* type, const uint8_t* data, size_t size);
+
+    std::vector<uint8_t> filtered;    // Filter byte and filtered bytes of every row
+    std::vector<uint8_t> candidate;   // One row per filter while choosing
+    std::vector<int32_t> head;        // LZ77 hash chains
+    std::vector<int32_t> previous;
+    std::vector<uint8_t> compressed;
+    std::vector<uint8_t> output;
+    uint32_t bitBuffer;
+    int bitCount;
+};
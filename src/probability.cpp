@@ -0,0 +1,631 @@
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include "probability.h"
+
+namespace {
+    // A state is one bit per cell still needed, so bands wider than this are not attempted
+    const int MAX_BAND_WIDTH = 63;
+    // Caps on the tables kept for the backward pass
+    const size_t MAX_STEP_STATES = 1 << 18;
+    const size_t MAX_STORED_COUNTS = 1 << 23;
+
+    double LogChoose(int n, int k) {
+        if (k < 0 || k > n) {
+            return -INFINITY;
+        }
+        return std::lgamma(n + 1.0) - std::lgamma(k + 1.0) - std::lgamma(n - k + 1.0);
+    }
+
+    // Distribution over mine counts, stored relative to exp(logScale) to avoid overflow
+    struct ScaledCounts {
+        std::vector<double> weights;
+        double logScale;
+    };
+
+    ScaledCounts Convolve(const ScaledCounts& a, const ScaledCounts& b) {
+        ScaledCounts result;
+        result.weights.assign(a.weights.size() + b.weights.size() - 1, 0.0);
+        for (size_t i = 0; i < a.weights.size(); ++i) {
+            for (size_t j = 0; j < b.weights.size(); ++j) {
+                result.weights[i + j] += a.weights[i] * b.weights[j];
+            }
+        }
+        double maxWeight = *std::max_element(result.weights.begin(), result.weights.end());
+        result.logScale = a.logScale + b.logScale;
+        if (maxWeight > 0.0) {
+            for (double& weight : result.weights) {
+                weight /= maxWeight;
+            }
+            result.logScale += std::log(maxWeight);
+        }
+        return result;
+    }
+}
+
+const signed char PlayerView::UNREVEALED;
+
+PlayerView PlayerView::FromBoard(const Board& board) {
+    PlayerView view;
+    view.rows = board.Rows();
+    view.cols = board.Cols();
+    view.cells.resize(view.rows * view.cols);
+    for (int index = 0; index < view.rows * view.cols; ++index) {
+        const Cell& cell = board.AtIndex(index);
+        view.cells[index] = cell.state == CellState::REVEALED ? (signed char)cell.adjacentMines : UNREVEALED;
+    }
+    return view;
+}
+
+uint64_t PlayerView::Hash() const {
+    // FNV-1a over the dimensions and the visible cells
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    mix((uint64_t)rows);
+    mix((uint64_t)cols);
+    for (signed char cell : cells) {
+        mix((uint64_t)(unsigned char)cell);
+    }
+    return hash;
+}
+
+bool ProbabilitySolver::FindComponents(const PlayerView& view) {
+    int cellCount = view.rows * view.cols;
+    parent.assign(cellCount, -1);
+    auto find = [this](int index) {
+        while (parent[index] != index) {
+            parent[index] = parent[parent[index]];
+            index = parent[index];
+        }
+        return index;
+    };
+
+    // Unrevealed cells seen by the same number belong together
+    for (int index = 0; index < cellCount; ++index) {
+        if (view.cells[index] == PlayerView::UNREVEALED) continue;
+        int row = index / view.cols;
+        int col = index % view.cols;
+        int first = -1;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (!view.IsValidCell(row + dr, col + dc)) continue;
+                int neighbor = (row + dr) * view.cols + col + dc;
+                if (view.cells[neighbor] != PlayerView::UNREVEALED) continue;
+                if (parent[neighbor] < 0) {
+                    parent[neighbor] = neighbor;
+                }
+                if (first < 0) {
+                    first = find(neighbor);
+                } else {
+                    parent[find(neighbor)] = first;
+                }
+            }
+        }
+        // A number with nothing left around it must be a 0
+        if (first < 0 && view.cells[index] != 0) {
+            return false;
+        }
+    }
+
+    components.clear();
+    componentOf.assign(cellCount, -1);
+    for (int index = 0; index < cellCount; ++index) {
+        if (parent[index] < 0) continue;
+        int root = find(index);
+        if (componentOf[root] < 0) {
+            componentOf[root] = (int)components.size();
+            components.emplace_back();
+        }
+        componentOf[index] = componentOf[root];
+        components[componentOf[index]].cells.push_back(index);
+    }
+    for (int index = 0; index < cellCount; ++index) {
+        if (view.cells[index] == PlayerView::UNREVEALED) continue;
+        int row = index / view.cols;
+        int col = index % view.cols;
+        int component = -1;
+        for (int dr = -1; dr <= 1 && component < 0; ++dr) {
+            for (int dc = -1; dc <= 1 && component < 0; ++dc) {
+                if (!view.IsValidCell(row + dr, col + dc)) continue;
+                int neighbor = (row + dr) * view.cols + col + dc;
+                if (view.cells[neighbor] == PlayerView::UNREVEALED) {
+                    component = componentOf[neighbor];
+                }
+            }
+        }
+        if (component >= 0) {
+            components[component].numbers.push_back(index);
+        }
+    }
+    return true;
+}
+
+int ProbabilitySolver::PlanWidth(const PlayerView& view, const Component& component, const std::vector<int>& order) {
+    // Cell k stays in the state from its own step until the last step of any number that
+    // sees it; the width is the most cells alive at once
+    int size = (int)order.size();
+    for (int k = 0; k < size; ++k) {
+        localIndex[order[k]] = k;
+    }
+    std::vector<int> lastNeeded(size);
+    for (int k = 0; k < size; ++k) {
+        lastNeeded[k] = k;
+    }
+    for (size_t n = 0; n < component.numbers.size(); ++n) {
+        int last = 0;
+        for (int cell : numberCells[n]) {
+            last = std::max(last, localIndex[cell]);
+        }
+        for (int cell : numberCells[n]) {
+            lastNeeded[localIndex[cell]] = std::max(lastNeeded[localIndex[cell]], last);
+        }
+    }
+    (void)view;
+
+    std::vector<int> alive(size + 1, 0);
+    for (int k = 0; k < size; ++k) {
+        alive[k]++;
+        alive[std::max(k + 1, lastNeeded[k])]--;  // Alive through step lastNeeded - 1, and its own step
+    }
+    int width = 0;
+    int running = 0;
+    for (int k = 0; k < size; ++k) {
+        running += alive[k];
+        width = std::max(width, running);
+    }
+    for (int cell : order) {
+        localIndex[cell] = -1;
+    }
+    return width;
+}
+
+bool ProbabilitySolver::Plan(const PlayerView& view, Component& component) {
+    int size = (int)component.cells.size();
+    int numberCount = (int)component.numbers.size();
+    numberCells.assign(numberCount, std::vector<int>());
+    for (int n = 0; n < numberCount; ++n) {
+        int index = component.numbers[n];
+        int row = index / view.cols;
+        int col = index % view.cols;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                if (!view.IsValidCell(row + dr, col + dc)) continue;
+                int neighbor = (row + dr) * view.cols + col + dc;
+                if (view.cells[neighbor] == PlayerView::UNREVEALED) {
+                    numberCells[n].push_back(neighbor);
+                }
+            }
+        }
+        if ((int)numberCells[n].size() < view.cells[index]) {
+            return false;
+        }
+    }
+
+    // Candidate orders: by rows, by columns, and breadth-first from one end of the
+    // component, which follows bands that bend. Keep whichever is narrowest.
+    std::vector<std::vector<int>> orders(3);
+    orders[0] = component.cells;
+    orders[1] = component.cells;
+    std::sort(orders[1].begin(), orders[1].end(), [&view](int a, int b) {
+        int colA = a % view.cols;
+        int colB = b % view.cols;
+        return colA != colB ? colA < colB : a < b;
+    });
+
+    std::vector<std::vector<int>> cellNumbers(size);
+    for (int k = 0; k < size; ++k) {
+        localIndex[component.cells[k]] = k;
+    }
+    for (int n = 0; n < numberCount; ++n) {
+        for (int cell : numberCells[n]) {
+            cellNumbers[localIndex[cell]].push_back(n);
+        }
+    }
+    auto breadthFirst = [&](int start, std::vector<int>& order) {
+        std::vector<char> visited(size, 0);
+        std::queue<int> pending;
+        order.clear();
+        visited[start] = 1;
+        pending.push(start);
+        while (!pending.empty()) {
+            int k = pending.front();
+            pending.pop();
+            order.push_back(component.cells[k]);
+            for (int n : cellNumbers[k]) {
+                for (int cell : numberCells[n]) {
+                    int other = localIndex[cell];
+                    if (!visited[other]) {
+                        visited[other] = 1;
+                        pending.push(other);
+                    }
+                }
+            }
+        }
+    };
+    // The last cell reached from anywhere is a good guess at an end of the band
+    breadthFirst(0, orders[2]);
+    int end = localIndex[orders[2].back()];
+    breadthFirst(end, orders[2]);
+    for (int cell : component.cells) {
+        localIndex[cell] = -1;
+    }
+
+    int best = -1;
+    int bestWidth = 0;
+    for (int i = 0; i < (int)orders.size(); ++i) {
+        int width = PlanWidth(view, component, orders[i]);
+        if (best < 0 || width < bestWidth) {
+            best = i;
+            bestWidth = width;
+        }
+    }
+    if (bestWidth > MAX_BAND_WIDTH) {
+        return false;
+    }
+    component.cells = orders[best];
+
+    // Build the step plans: which old bits each new state keeps, and what each number
+    // seeing the new cell requires
+    for (int k = 0; k < size; ++k) {
+        localIndex[component.cells[k]] = k;
+    }
+    for (int k = 0; k < size; ++k) {
+        cellNumbers[k].clear();
+    }
+    for (int n = 0; n < numberCount; ++n) {
+        for (int cell : numberCells[n]) {
+            cellNumbers[localIndex[cell]].push_back(n);
+        }
+    }
+    std::vector<int> numberLast(numberCount, 0);
+    std::vector<int> lastNeeded(size);
+    for (int k = 0; k < size; ++k) {
+        lastNeeded[k] = k;
+    }
+    for (int n = 0; n < numberCount; ++n) {
+        for (int cell : numberCells[n]) {
+            numberLast[n] = std::max(numberLast[n], localIndex[cell]);
+        }
+        for (int cell : numberCells[n]) {
+            lastNeeded[localIndex[cell]] = std::max(lastNeeded[localIndex[cell]], numberLast[n]);
+        }
+    }
+
+    component.plans.assign(size, StepPlan());
+    std::vector<int> alive;     // Positions whose values the current state holds, by bit
+    std::vector<int> bitOf(size, -1);
+    for (int i = 0; i < size; ++i) {
+        StepPlan& plan = component.plans[i];
+        for (int k = 0; k < (int)alive.size(); ++k) {
+            bitOf[alive[k]] = k;
+        }
+        for (int n : cellNumbers[i]) {
+            uint64_t mask = 0;
+            int remaining = 0;
+            for (int cell : numberCells[n]) {
+                int k = localIndex[cell];
+                if (k < i) {
+                    mask |= 1ULL << bitOf[k];
+                } else if (k > i) {
+                    remaining++;
+                }
+            }
+            plan.numberMasks.push_back(mask);
+            plan.numberTargets.push_back(view.cells[component.numbers[n]]);
+            plan.numberRemaining.push_back(remaining);
+        }
+
+        std::vector<int> next;
+        for (int k : alive) {
+            if (lastNeeded[k] > i) {
+                next.push_back(k);
+                plan.sources.push_back(bitOf[k]);
+            }
+        }
+        next.push_back(i);
+        plan.sources.push_back(-1);
+        alive.swap(next);
+    }
+    for (int cell : component.cells) {
+        localIndex[cell] = -1;
+    }
+    return true;
+}
+
+bool ProbabilitySolver::Advance(const StepPlan& plan, uint64_t state, int value, uint64_t& next) const {
+    for (size_t n = 0; n < plan.numberMasks.size(); ++n) {
+        int mines = __builtin_popcountll(state & plan.numberMasks[n]) + value;
+        if (mines > plan.numberTargets[n] || mines + plan.numberRemaining[n] < plan.numberTargets[n]) {
+            return false;
+        }
+    }
+    next = 0;
+    for (size_t bit = 0; bit < plan.sources.size(); ++bit) {
+        int source = plan.sources[bit];
+        uint64_t bitValue = source < 0 ? (uint64_t)value : (state >> source) & 1;
+        next |= bitValue << bit;
+    }
+    return true;
+}
+
+bool ProbabilitySolver::IsCheckpoint(const Component& component, int step) const {
+    return (step + 1) % component.checkpointInterval == 0 || step == (int)component.cells.size() - 1;
+}
+
+void ProbabilitySolver::ComputeStep(Component& component, int step, const uint64_t* previousStates,
+                                    const double* previousCounts, size_t previousCount, bool addStates,
+                                    std::vector<double>& counts) {
+    StepTable& table = component.tables[step];
+    int previousRow = step + 1;  // Mines so far: 0..step before this cell
+    int row = step + 2;
+    counts.assign(table.states.size() * row, 0.0);
+
+    for (size_t p = 0; p < previousCount; ++p) {
+        for (int value = 0; value <= 1; ++value) {
+            uint64_t next;
+            if (!Advance(component.plans[step], previousStates[p], value, next)) continue;
+            auto found = table.lookup.find(next);
+            int index;
+            if (found != table.lookup.end()) {
+                index = found->second;
+            } else if (addStates) {
+                index = (int)table.states.size();
+                table.lookup[next] = index;
+                table.states.push_back(next);
+                counts.resize(counts.size() + row, 0.0);
+            } else {
+                continue;
+            }
+            double* to = &counts[(size_t)index * row];
+            const double* from = previousCounts + p * previousRow;
+            for (int m = 0; m < previousRow; ++m) {
+                to[m + value] += from[m];
+            }
+        }
+    }
+}
+
+bool ProbabilitySolver::Forward(Component& component) {
+    int size = (int)component.cells.size();
+    component.tables.assign(size, StepTable());
+    component.checkpointInterval = std::max(1, (int)std::sqrt((double)size));
+    component.logScale = 0.0;
+
+    // Before the first cell there is one empty state with one layout
+    const uint64_t emptyState = 0;
+    std::vector<double> previous(1, 1.0);
+    std::vector<double> current;
+    const uint64_t* previousStates = &emptyState;
+    size_t previousCount = 1;
+
+    for (int i = 0; i < size; ++i) {
+        ComputeStep(component, i, previousStates, previous.data(), previousCount, true, current);
+        StepTable& table = component.tables[i];
+        if (table.states.empty()) {
+            return false;  // No layout satisfies the numbers
+        }
+        if (table.states.size() > MAX_STEP_STATES) {
+            return false;
+        }
+
+        // A common factor per step keeps the counts in range without changing any ratio
+        double maxCount = *std::max_element(current.begin(), current.end());
+        for (double& count : current) {
+            count /= maxCount;
+        }
+        component.logScale += std::log(maxCount);
+
+        if (IsCheckpoint(component, i)) {
+            table.counts = current;
+            storedCounts += current.size();
+            if (storedCounts > MAX_STORED_COUNTS) {
+                return false;
+            }
+        }
+        previous.swap(current);
+        previousStates = table.states.data();
+        previousCount = table.states.size();
+    }
+
+    const StepTable& last = component.tables[size - 1];
+    component.layouts.assign(size + 1, 0.0);
+    for (size_t s = 0; s < last.states.size(); ++s) {
+        for (int m = 0; m <= size; ++m) {
+            component.layouts[m] += last.counts[s * (size + 1) + m];
+        }
+    }
+    return true;
+}
+
+void ProbabilitySolver::Backward(Component& component, const std::vector<double>& outside,
+                                 std::vector<double>& probabilities) {
+    // after[s][m]: weight of finishing from state s with m mines so far, including
+    // everything outside the component. Forward count times this, summed over the states
+    // of one step, splits all weight by the value of that step's cell.
+    int size = (int)component.cells.size();
+    std::vector<double> after(component.tables[size - 1].states.size() * (size + 1));
+    for (size_t s = 0; s < component.tables[size - 1].states.size(); ++s) {
+        for (int m = 0; m <= size; ++m) {
+            after[s * (size + 1) + m] = outside[m];
+        }
+    }
+
+    std::vector<double> before;
+    std::vector<std::vector<double>> segment;  // Forward counts of the steps being walked back over
+    int segmentStart = size;
+    const uint64_t emptyState = 0;
+    const double oneLayout = 1.0;
+
+    for (int i = size - 1; i >= 0; --i) {
+        if (i < segmentStart) {
+            // Replay forward from the checkpoint before this segment
+            segmentStart = i / component.checkpointInterval * component.checkpointInterval;
+            segment.assign(i - segmentStart + 1, std::vector<double>());
+            for (int step = segmentStart; step <= i; ++step) {
+                if (!component.tables[step].counts.empty()) {
+                    segment[step - segmentStart] = component.tables[step].counts;
+                    continue;
+                }
+                const uint64_t* states = &emptyState;
+                const double* counts = &oneLayout;
+                size_t count = 1;
+                if (step > 0) {
+                    const StepTable& previous = component.tables[step - 1];
+                    states = previous.states.data();
+                    counts = step > segmentStart ? segment[step - segmentStart - 1].data() : previous.counts.data();
+                    count = previous.states.size();
+                }
+                ComputeStep(component, step, states, counts, count, false, segment[step - segmentStart]);
+            }
+        }
+        const std::vector<double>& forward = segment[i - segmentStart];
+
+        const StepTable& table = component.tables[i];
+        int row = i + 2;
+        int cellBit = (int)component.plans[i].sources.size() - 1;
+        double weight[2] = { 0.0, 0.0 };
+        for (size_t s = 0; s < table.states.size(); ++s) {
+            double sum = 0.0;
+            for (int m = 0; m < row; ++m) {
+                sum += forward[s * row + m] * after[s * row + m];
+            }
+            weight[(table.states[s] >> cellBit) & 1] += sum;
+        }
+        double total = weight[0] + weight[1];
+        probabilities[component.cells[i]] = total > 0.0 ? weight[1] / total : 0.0;
+
+        if (i == 0) {
+            break;
+        }
+        const StepTable& previous = component.tables[i - 1];
+        int previousRow = i + 1;
+        before.assign(previous.states.size() * previousRow, 0.0);
+        for (size_t p = 0; p < previous.states.size(); ++p) {
+            for (int value = 0; value <= 1; ++value) {
+                uint64_t next;
+                if (!Advance(component.plans[i], previous.states[p], value, next)) continue;
+                auto found = table.lookup.find(next);
+                if (found == table.lookup.end()) continue;
+                const double* from = &after[(size_t)found->second * row];
+                for (int m = 0; m < previousRow; ++m) {
+                    before[p * previousRow + m] += from[m + value];
+                }
+            }
+        }
+        double maxWeight = *std::max_element(before.begin(), before.end());
+        if (maxWeight > 0.0) {
+            for (double& value : before) {
+                value /= maxWeight;
+            }
+        }
+        after.swap(before);
+    }
+}
+
+bool ProbabilitySolver::Solve(const PlayerView& view, int totalMines, ProbabilityResult& out) {
+    int cellCount = view.rows * view.cols;
+    out.mineProbability.assign(cellCount, 0.0);
+    out.logWeight = -INFINITY;
+
+    if (!FindComponents(view)) {
+        return false;
+    }
+    localIndex.assign(cellCount, -1);
+    storedCounts = 0;
+    int frontierCount = 0;
+    for (Component& component : components) {
+        frontierCount += (int)component.cells.size();
+        if (!Plan(view, component) || !Forward(component)) {
+            return false;
+        }
+    }
+    int unrevealedCount = (int)std::count(view.cells.begin(), view.cells.end(), PlayerView::UNREVEALED);
+    int interiorCount = unrevealedCount - frontierCount;
+
+    // prefix[j] combines components before j, suffix[j] those from j on, so each component
+    // can be weighed against all the others without redoing the whole product
+    int count = (int)components.size();
+    std::vector<ScaledCounts> prefix(count + 1);
+    std::vector<ScaledCounts> suffix(count + 1);
+    prefix[0] = { { 1.0 }, 0.0 };
+    suffix[count] = { { 1.0 }, 0.0 };
+    for (int j = 0; j < count; ++j) {
+        prefix[j + 1] = Convolve(prefix[j], { components[j].layouts, components[j].logScale });
+    }
+    for (int j = count - 1; j >= 0; --j) {
+        suffix[j] = Convolve(suffix[j + 1], { components[j].layouts, components[j].logScale });
+    }
+
+    // Total weight: every split of the mines between the frontier and the interior
+    const ScaledCounts& all = prefix[count];
+    std::vector<double> logTerms;
+    for (size_t m = 0; m < all.weights.size(); ++m) {
+        if (all.weights[m] > 0.0) {
+            logTerms.push_back(all.logScale + std::log(all.weights[m]) + LogChoose(interiorCount, totalMines - (int)m));
+        }
+    }
+    double maxLog = logTerms.empty() ? -INFINITY : *std::max_element(logTerms.begin(), logTerms.end());
+    if (maxLog == -INFINITY) {
+        return false;
+    }
+    double sum = 0.0;
+    for (double term : logTerms) {
+        sum += std::exp(term - maxLog);
+    }
+    out.logWeight = maxLog + std::log(sum);
+
+    // Interior cells: expected interior mines over the interior size
+    if (interiorCount > 0) {
+        double expected = 0.0;
+        for (size_t m = 0; m < all.weights.size(); ++m) {
+            if (all.weights[m] <= 0.0) continue;
+            int interiorMines = totalMines - (int)m;
+            if (interiorMines < 0 || interiorMines > interiorCount) continue;
+            double logTerm = all.logScale + std::log(all.weights[m]) + LogChoose(interiorCount, interiorMines);
+            expected += std::exp(logTerm - out.logWeight) * interiorMines;
+        }
+        double probability = expected / interiorCount;
+        for (int index = 0; index < cellCount; ++index) {
+            if (view.cells[index] == PlayerView::UNREVEALED && componentOf[index] < 0) {
+                out.mineProbability[index] = probability;
+            }
+        }
+    }
+
+    // Frontier cells: weigh each count of mines in a component by the ways the other
+    // components and the interior can hold the rest, then run the backward pass
+    std::vector<double> outside;
+    for (int j = 0; j < count; ++j) {
+        ScaledCounts others = Convolve(prefix[j], suffix[j + 1]);
+        int size = (int)components[j].cells.size();
+        std::vector<double> logOutside(size + 1, -INFINITY);
+        for (int m = 0; m <= size; ++m) {
+            double best = -INFINITY;
+            std::vector<double> terms;
+            for (size_t o = 0; o < others.weights.size(); ++o) {
+                if (others.weights[o] <= 0.0) continue;
+                double term = std::log(others.weights[o]) + LogChoose(interiorCount, totalMines - m - (int)o);
+                if (term == -INFINITY) continue;
+                terms.push_back(term);
+                best = std::max(best, term);
+            }
+            if (best == -INFINITY) continue;
+            double termSum = 0.0;
+            for (double term : terms) {
+                termSum += std::exp(term - best);
+            }
+            logOutside[m] = best + std::log(termSum);
+        }
+        double maxOutside = *std::max_element(logOutside.begin(), logOutside.end());
+        outside.assign(size + 1, 0.0);
+        for (int m = 0; m <= size; ++m) {
+            outside[m] = std::exp(logOutside[m] - maxOutside);
+        }
+        Backward(components[j], outside, out.mineProbability);
+    }
+    return true;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "board.h"
+
+// What the player can see, and nothing else: the number on each revealed cell, or
+// UNREVEALED. Solvers work on views so they can't peek at the mines, and so hypothetical
+// positions ("what if this cell showed a 2?") are cheap to build.
+struct PlayerView {
+    static const signed char UNREVEALED = -1;
+
+    int rows;
+    int cols;
+    std::vector<signed char> cells;
+
+    static PlayerView FromBoard(const Board& board);
+    bool IsValidCell(int row, int col) const { return row >= 0 && row < rows && col >= 0 && col < cols; }
+    uint64_t Hash() const;
+};
+
+struct ProbabilityResult {
+    std::vector<double> mineProbability;  // Per cell; 0 for revealed cells
+    double logWeight;                     // Log of the number of mine layouts the view allows
+};
+
+// Exact mine probabilities for every unrevealed cell, counting every layout of the total
+// number of mines that agrees with the view. Each frontier component is solved by dynamic
+// programming along an ordering of its cells (a path decomposition): the state is the
+// assignment of the cells some unfinished number still needs, so the cost grows with the
+// width of the frontier band rather than its length. Components are then combined with
+// the interior through binomial weights.
+class ProbabilitySolver
+{
+public:
+    // Returns false if the view contradicts itself or a component's band is too wide
+    bool Solve(const PlayerView& view, int totalMines, ProbabilityResult& out);
+
+private:
+    // How step i turns the states after cell i - 1 into the states after cell i
+    struct StepPlan {
+        std::vector<int> sources;                 // Per bit of the new state: bit in the old state, -1 for cell i
+        std::vector<uint64_t> numberMasks;        // Per number seeing cell i: its cells in the old state
+        std::vector<int> numberTargets;
+        std::vector<int> numberRemaining;         // Its cells after cell i
+    };
+
+    // States after one step, and their layout counts by mines so far. Counts are only kept
+    // at checkpoints; the backward pass recomputes the steps in between a segment at a time.
+    struct StepTable {
+        std::vector<uint64_t> states;
+        std::vector<double> counts;               // states.size() rows of (step + 2) counts
+        std::unordered_map<uint64_t, int> lookup;
+    };
+
+    struct Component {
+        std::vector<int> cells;       // In elimination order once planned
+        std::vector<int> numbers;
+        std::vector<StepPlan> plans;  // One per cell
+        std::vector<StepTable> tables;
+        int checkpointInterval;
+        std::vector<double> layouts;  // Per mine count, relative to exp(logScale)
+        double logScale;
+    };
+
+    bool FindComponents(const PlayerView& view);
+    int PlanWidth(const PlayerView& view, const Component& component, const std::vector<int>& order);
+    bool Plan(const PlayerView& view, Component& component);
+    bool Forward(Component& component);
+    void ComputeStep(Component& component, int step, const uint64_t* previousStates, const double* previousCounts,
+                     size_t previousCount, bool addStates, std::vector<double>& counts);
+    bool IsCheckpoint(const Component& component, int step) const;
+    void Backward(Component& component, const std::vector<double>& outside, std::vector<double>& probabilities);
+    bool Advance(const StepPlan& plan, uint64_t state, int value, uint64_t& next) const;
+
+    std::vector<Component> components;
+    std::vector<int> parent;
+    std::vector<int> componentOf;
+    std::vector<int> localIndex;            // Cell -> position in the component being planned
+
+    std::vector<std::vector<int>> numberCells;  // Per component number: its cells' positions
+    size_t storedCounts;                        // Counts kept in all tables, against a memory cap
+};
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cstring>
+
+#include "board.h"
+#include "render.h"
+
+namespace {
+    // Colors as RGBA words in memory order (red in the low byte)
+    uint32_t Rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a = 255) {
+        return r | (g << 8) | (b << 16) | (a << 24);
+    }
+
+    const uint32_t GAP_COLOR = Rgba(0, 0, 0);
+    const uint32_t HIDDEN_COLOR = Rgba(0, 255, 255);     // Aqua, as Game::DrawCell
+    const uint32_t OPEN_COLOR = Rgba(135, 206, 235);     // Sky blue for revealed and flagged cells
+    const float SATISFIED_NUMBER_ALPHA = 0.45f;          // Game::SATISFIED_NUMBER_ALPHA
+
+    // Multiplies all four channels by scale/255, two channels per multiply
+    uint32_t ScalePixel(uint32_t pixel, uint32_t scale) {
+        uint32_t rb = (pixel & 0x00ff00ff) * scale;
+        uint32_t ga = ((pixel >> 8) & 0x00ff00ff) * scale;
+        rb = ((rb + 0x00800080 + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+        ga = (ga + 0x00800080 + ((ga >> 8) & 0x00ff00ff)) & 0xff00ff00;
+        return rb | ga;
+    }
+
+    // Premultiplied source over an opaque destination
+    uint32_t Over(uint32_t source, uint32_t destination) {
+        return source + ScalePixel(destination, 255 - (source >> 24));
+    }
+
+    // Box-filtered, premultiplied copy of a sprite at size x size; each output pixel averages
+    // the source pixels under it, or takes the nearest one when enlarging
+    std::vector<uint32_t> ScaleSprite(const RgbaImage& sprite, int size) {
+        std::vector<uint32_t> scaled(size * size, 0);
+        if (sprite.pixels.empty()) {
+            return scaled;  // Not loaded: draw nothing
+        }
+        for (int y = 0; y < size; ++y) {
+            int y0 = y * sprite.height / size;
+            int y1 = std::max(y0 + 1, (y + 1) * sprite.height / size);
+            for (int x = 0; x < size; ++x) {
+                int x0 = x * sprite.width / size;
+                int x1 = std::max(x0 + 1, (x + 1) * sprite.width / size);
+                uint64_t sum[4] = { 0, 0, 0, 0 };
+                for (int sy = y0; sy < y1; ++sy) {
+                    for (int sx = x0; sx < x1; ++sx) {
+                        uint32_t pixel = sprite.pixels[sy * sprite.width + sx];
+                        uint32_t alpha = pixel >> 24;
+                        sum[0] += (pixel & 0xff) * alpha;
+                        sum[1] += ((pixel >> 8) & 0xff) * alpha;
+                        sum[2] += ((pixel >> 16) & 0xff) * alpha;
+                        sum[3] += alpha * 255;
+                    }
+                }
+                uint64_t count = (uint64_t)(y1 - y0) * (x1 - x0) * 255;
+                scaled[y * size + x] = Rgba((uint32_t)((sum[0] + count / 2) / count), (uint32_t)((sum[1] + count / 2) / count),
+                                            (uint32_t)((sum[2] + count / 2) / count), (uint32_t)((sum[3] + count / 2) / count));
+            }
+        }
+        return scaled;
+    }
+}
+
+bool BoardRenderer::LoadSprites(const std::string& dataDir) {
+    bool loaded = LoadPng(dataDir + "/bomb.png", bomb) && LoadPng(dataDir + "/flag.png", flag);
+    for (int i = 0; i < 8 && loaded; ++i) {
+        loaded = LoadPng(dataDir + "/" + std::to_string(i + 1) + ".png", numbers[i]);
+    }
+    cellSize = 0;  // Tiles must be baked again from the new sprites
+    return loaded;
+}
+
+void BoardRenderer::BakeTile(int kind, uint32_t background, const std::vector<uint32_t>* sprite, int spriteSize,
+                             float alpha) {
+    uint32_t* tile = &tiles[kind * cellSize * cellSize];
+    int gap = cellSize >= 3 ? 1 : 0;  // Tiny cells have no room for grid lines
+    uint32_t scale = (uint32_t)(alpha * 255.0f + 0.5f);
+    for (int y = 0; y < cellSize; ++y) {
+        for (int x = 0; x < cellSize; ++x) {
+            bool inside = x < cellSize - gap && y < cellSize - gap;
+            uint32_t pixel = inside ? background : GAP_COLOR;
+            if (inside && sprite && x < spriteSize && y < spriteSize) {
+                uint32_t source = (*sprite)[y * spriteSize + x];
+                pixel = Over(scale == 255 ? source : ScalePixel(source, scale), pixel);
+            }
+            tile[y * cellSize + x] = pixel;
+        }
+    }
+}
+
+void BoardRenderer::Prepare(int cellSize) {
+    cellSize = std::max(1, cellSize);
+    if (cellSize == this->cellSize) {
+        return;
+    }
+    this->cellSize = cellSize;
+    tiles.assign(TILE_COUNT * cellSize * cellSize, GAP_COLOR);
+
+    // Sprites are drawn 2 pixels smaller than the cell from its top-left corner, as in the game
+    int spriteSize = std::max(1, cellSize - 2);
+    std::vector<uint32_t> scaled = ScaleSprite(bomb, spriteSize);
+    BakeTile(TILE_HIDDEN, HIDDEN_COLOR, nullptr, 0, 1.0f);
+    BakeTile(TILE_EMPTY, OPEN_COLOR, nullptr, 0, 1.0f);
+    BakeTile(TILE_MINE, OPEN_COLOR, &scaled, spriteSize, 1.0f);
+    scaled = ScaleSprite(flag, spriteSize);
+    BakeTile(TILE_FLAG, OPEN_COLOR, &scaled, spriteSize, 1.0f);
+    for (int i = 0; i < 8; ++i) {
+        scaled = ScaleSprite(numbers[i], spriteSize);
+        BakeTile(TILE_NUMBER + i, OPEN_COLOR, &scaled, spriteSize, 1.0f);
+        BakeTile(TILE_SATISFIED + i, OPEN_COLOR, &scaled, spriteSize, SATISFIED_NUMBER_ALPHA);
+    }
+}
+
+int BoardRenderer::TileFor(const Board& board, int row, int col) {
+    const Cell& cell = board.At(row, col);
+    if (cell.state == CellState::HIDDEN) return TILE_HIDDEN;
+    if (cell.state == CellState::FLAGGED) return TILE_FLAG;
+    if (cell.hasMine) return TILE_MINE;
+    if (cell.adjacentMines == 0) return TILE_EMPTY;
+    return (board.IsSatisfied(row, col) ? TILE_SATISFIED : TILE_NUMBER) + cell.adjacentMines - 1;
+}
+
+void BoardRenderer::Render(const Board& board, RgbaImage& image) const {
+    int cols = board.Cols();
+    image.Resize(cols * cellSize, board.Rows() * cellSize);
+    if (cellSize == 0 || image.pixels.empty()) {
+        return;
+    }
+
+    // Row by row through the image, so writes are sequential: each board row picks its tiles
+    // once and then copies one tile row per cell for every pixel row
+    std::vector<const uint32_t*> rowTiles(cols);
+    size_t tileRowBytes = cellSize * sizeof(uint32_t);
+    uint32_t* out = image.pixels.data();
+    for (int row = 0; row < board.Rows(); ++row) {
+        for (int col = 0; col < cols; ++col) {
+            rowTiles[col] = &tiles[TileFor(board, row, col) * cellSize * cellSize];
+        }
+        for (int y = 0; y < cellSize; ++y) {
+            for (int col = 0; col < cols; ++col, out += cellSize) {
+                std::memcpy(out, rowTiles[col] + y * cellSize, tileRowBytes);
+            }
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "png.h"
+
+class Board;
+
+// Draws boards into RGBA images on the CPU, with no GL context, the way the game draws its
+// grid: a black 1-pixel gap between cells, aqua hidden cells, sky-blue open cells and the
+// sprites from data/ on top. Prepare() scales the sprites to the cell size once and bakes
+// every kind of cell into an opaque tile, so rendering a board is nothing but copying tile
+// rows into the image. Render() only reads the tiles, so threads can share one renderer.
+class BoardRenderer
+{
+public:
+    BoardRenderer() : cellSize(0) {}
+
+    bool LoadSprites(const std::string& dataDir);  // bomb.png, flag.png and 1.png to 8.png
+    void Prepare(int cellSize);                    // Any size from 1 pixel per cell up
+    int CellSize() const { return cellSize; }
+
+    void Render(const Board& board, RgbaImage& image) const;
+
+private:
+    enum TileKind {
+        TILE_HIDDEN,
+        TILE_EMPTY,
+        TILE_NUMBER,                   // 1 to 8
+        TILE_SATISFIED = TILE_NUMBER + 8,  // Numbers with all their flags, dimmed as in the game
+        TILE_FLAG = TILE_SATISFIED + 8,
+        TILE_MINE,
+        TILE_COUNT
+    };
+
+    static int TileFor(const Board& board, int row, int col);
+    void BakeTile(int kind, uint32_t background, const std::vector<uint32_t>* sprite, int spriteSize, float alpha);
+
+    RgbaImage bomb;
+    RgbaImage flag;
+    RgbaImage numbers[8];
+    int cellSize;
+    std::vector<uint32_t> tiles;  // TILE_COUNT tiles of cellSize x cellSize pixels
+};
@@ -0,0 +1,187 @@
+#include <cstring>
+#include <iostream>
+
+#include "replay.h"
+
+static const char REPLAY_MAGIC[4] = { 'M', 'S', 'R', 'P' };
+static const unsigned char REPLAY_VERSION = 2;  // 2: boards are generated from striped random streams
+static const unsigned int MAX_REPLAY_CELLS = 1u << 24;  // Far past any board we make; corrupt headers go over
+
+static void AppendVarint(std::vector<unsigned char>& out, unsigned int value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+ReplayRecorder::ReplayRecorder()
+    : recording(false), header({ 0, 0, 0, 0 }), lastTimeMs(0)
+{
+}
+
+void ReplayRecorder::Begin(const ReplayHeader& header) {
+    this->header = header;
+    lastTimeMs = 0;
+    data.clear();
+    recording = true;
+}
+
+void ReplayRecorder::Stop() {
+    recording = false;
+    data.clear();
+}
+
+void ReplayRecorder::Record(MoveType type, int row, int col, float gameTime) {
+    if (!recording) {
+        return;
+    }
+
+    unsigned int timeMs = static_cast<unsigned int>(gameTime * 1000.0f);
+    if (timeMs < lastTimeMs) {
+        timeMs = lastTimeMs;
+    }
+    unsigned int cellIndex = static_cast<unsigned int>(row * header.cols + col);
+
+    AppendVarint(data, timeMs - lastTimeMs);
+    AppendVarint(data, (cellIndex << 2) | static_cast<unsigned int>(type));
+    lastTimeMs = timeMs;
+}
+
+bool ReplayRecorder::SaveToFile(const std::string& filename) const {
+    if (!recording) {
+        return false;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+#ifdef DEBUG
+        std::cerr << "Failed to open replay file for saving: " << filename << std::endl;
+#endif
+        return false;
+    }
+
+    // Encode the header with the same varint scheme as the moves
+    std::vector<unsigned char> headerData;
+    AppendVarint(headerData, (unsigned int)header.rows);
+    AppendVarint(headerData, (unsigned int)header.cols);
+    AppendVarint(headerData, (unsigned int)header.mineCount);
+    AppendVarint(headerData, header.seed);
+
+    file.write(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    file.write(reinterpret_cast<const char*>(&REPLAY_VERSION), 1);
+    file.write(reinterpret_cast<const char*>(headerData.data()), headerData.size());
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return file.good();
+}
+
+ReplayReader::ReplayReader()
+    : header({ 0, 0, 0, 0 }), pending({ 0, MoveType::REVEAL, 0, 0 }), hasPending(false),
+      finished(true), truncated(false), lastTimeMs(0)
+{
+}
+
+bool ReplayReader::Open(const std::string& filename) {
+    Close();
+    file.open(filename, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    char magic[4];
+    unsigned char version = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), 1);
+    if (!file || memcmp(magic, REPLAY_MAGIC, sizeof(magic)) != 0 || version != REPLAY_VERSION) {
+#ifdef DEBUG
+        std::cerr << "Not a valid replay file: " << filename << std::endl;
+#endif
+        Close();
+        return false;
+    }
+
+    unsigned int rows, cols, mineCount, seed;
+    if (!ReadVarint(rows) || !ReadVarint(cols) || !ReadVarint(mineCount) || !ReadVarint(seed) ||
+        rows == 0 || cols == 0 || rows > MAX_REPLAY_CELLS || cols > MAX_REPLAY_CELLS ||
+        (unsigned long long)rows * cols > MAX_REPLAY_CELLS || mineCount > rows * cols) {
+#ifdef DEBUG
+        std::cerr << "Replay header is damaged: " << filename << std::endl;
+#endif
+        Close();
+        return false;
+    }
+    header = { (int)rows, (int)cols, (int)mineCount, seed };
+
+    finished = false;
+    lastTimeMs = 0;
+    DecodeNext();
+    return true;
+}
+
+void ReplayReader::Close() {
+    if (file.is_open()) {
+        file.close();
+    }
+    file.clear();
+    hasPending = false;
+    finished = true;
+    truncated = false;
+}
+
+bool ReplayReader::ReadVarint(unsigned int& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        int byte = file.get();
+        if (byte == std::char_traits<char>::eof()) {
+            return false;
+        }
+        value |= static_cast<unsigned int>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReplayReader::DecodeNext() {
+    // Running out exactly between moves is the normal end; anywhere else the file was cut off
+    bool atEnd = file.peek() == std::char_traits<char>::eof();
+    unsigned int delta, packed;
+    if (atEnd || !ReadVarint(delta) || !ReadVarint(packed)) {
+        hasPending = false;
+        finished = true;
+        truncated = !atEnd;
+        return false;
+    }
+
+    unsigned int cellIndex = packed >> 2;
+    lastTimeMs += delta;
+    pending.timeMs = lastTimeMs;
+    pending.type = static_cast<MoveType>(packed & 0x3);
+    pending.row = static_cast<int>(cellIndex / header.cols);
+    pending.col = static_cast<int>(cellIndex % header.cols);
+    hasPending = true;
+    return true;
+}
+
+bool ReplayReader::NextDueMove(float gameTime, ReplayMove& move) {
+    if (!hasPending) {
+        return false;
+    }
+    if (pending.timeMs > static_cast<unsigned int>(gameTime * 1000.0f)) {
+        return false;
+    }
+
+    move = pending;
+    DecodeNext();
+    return true;
+}
+
+bool ReplayReader::Next(ReplayMove& move) {
+    if (!hasPending) {
+        return false;
+    }
+    move = pending;
+    DecodeNext();
+    return true;
+}
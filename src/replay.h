@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+
+// Player actions stored in a replay
+enum class MoveType {
+    REVEAL = 0,
+    FLAG = 1,   // Flag or unflag
+    CHORD = 2
+};
+
+struct ReplayMove {
+    unsigned int timeMs;  // Game time of the move
+    MoveType type;
+    int row;
+    int col;
+};
+
+struct ReplayHeader {
+    int rows;
+    int cols;
+    int mineCount;
+    unsigned int seed;  // Board seed, so the replay can be played back on the same board
+};
+
+// Replay file layout: "MSRP", version byte, header varints, then one record per move:
+// varint(time delta in ms), varint(cell index << 2 | move type).
+// Varints keep a typical move at 2-4 bytes and let the reader decode one move at a time.
+
+// Records the moves of the current game in memory and writes them out on demand
+class ReplayRecorder
+{
+public:
+    ReplayRecorder();
+
+    void Begin(const ReplayHeader& header);
+    void Stop();  // Stop recording, e.g. after loading a board that has no seed
+    bool IsRecording() const { return recording; }
+    void Record(MoveType type, int row, int col, float gameTime);
+    bool SaveToFile(const std::string& filename) const;
+
+private:
+    bool recording;
+    ReplayHeader header;
+    unsigned int lastTimeMs;
+    std::vector<unsigned char> data;
+};
+
+// Streams a replay file, decoding moves only when they are due
+class ReplayReader
+{
+public:
+    ReplayReader();
+
+    bool Open(const std::string& filename);
+    void Close();
+    bool IsOpen() const { return file.is_open(); }
+    const ReplayHeader& Header() const { return header; }
+
+    // Decodes the next move if its time is <= gameTime. Returns false if no move is due yet
+    // or the replay has ended.
+    bool NextDueMove(float gameTime, ReplayMove& move);
+    bool Next(ReplayMove& move);  // The next move whatever its time, for reading a whole replay
+    bool Finished() const { return finished; }
+    bool Truncated() const { return truncated; }  // Finished partway through a move: the file is damaged
+
+private:
+    bool ReadVarint(unsigned int& value);
+    bool DecodeNext();
+
+    std::ifstream file;
+    ReplayHeader header;
+    ReplayMove pending;
+    bool hasPending;
+    bool finished;
+    bool truncated;
+    unsigned int lastTimeMs;
+};
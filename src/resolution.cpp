@@ -0,0 +1,101 @@
+#include <algorithm>
+
+#include "resolution.h"
+
+namespace {
+    const float OVER_BUDGET = 1.2f;      // Average over budget * this counts as too slow
+    const float WITHIN_BUDGET = 1.05f;   // Average under budget * this counts as headroom
+    const float AVERAGE_WEIGHT = 0.1f;   // Of the newest frame in the average, about 10 frames
+    const float MAX_SAMPLE = 10.0f;      // Longest frame counted, in budgets, so one hitch can't trigger a step
+    const float STEP_DOWN_DELAY = 0.5f;  // Seconds too slow before stepping down
+    const float BASE_UP_DELAY = 3.0f;    // Seconds of headroom before stepping up
+    const float MAX_UP_DELAY = 48.0f;
+    const float REVERT_WINDOW = 5.0f;    // A step down this soon after a step up means it didn't hold
+    const float SETTLE_TIME = 0.25f;     // Frames ignored after a change, while render targets are rebuilt
+    const float STARTUP_SETTLE_TIME = 1.0f;
+    const float VERIFY_TIME = 1.0f;      // Seconds at a new, lower level before judging it
+    const float MIN_IMPROVEMENT = 0.9f;  // A step down must bring the average under this share of before
+}
+
+const int ResolutionScaler::LEVEL_COUNT;
+const float ResolutionScaler::LEVELS[LEVEL_COUNT] = { 1.0f, 0.85f, 0.7f, 0.55f, 0.4f };
+
+ResolutionScaler::ResolutionScaler(float budgetSeconds)
+    : budget(budgetSeconds), level(0), lowestUseful(LEVEL_COUNT - 1), average(budgetSeconds), overTime(0.0f),
+      underTime(0.0f), settleTime(STARTUP_SETTLE_TIME), sinceStepUp(REVERT_WINDOW),
+      upDelay(BASE_UP_DELAY), verifyingStep(false), levelTime(0.0f), levelFrames(0), meanBeforeStep(0.0f)
+{
+}
+
+bool ResolutionScaler::Update(float frameSeconds) {
+    if (settleTime > 0.0f) {
+        settleTime -= frameSeconds;
+        return false;
+    }
+    float sample = std::min(frameSeconds, budget * MAX_SAMPLE);
+    average += (sample - average) * AVERAGE_WEIGHT;
+    levelTime += sample;
+    levelFrames++;
+
+    // A step up that has held long enough earns back some of the backoff
+    if (sinceStepUp < REVERT_WINDOW && sinceStepUp + frameSeconds >= REVERT_WINDOW) {
+        upDelay = std::max(BASE_UP_DELAY, upDelay * 0.5f);
+    }
+    sinceStepUp += frameSeconds;
+
+    // Resolution wasn't what held frames back, so rendering less only blurred the picture
+    if (verifyingStep && levelTime >= VERIFY_TIME) {
+        verifyingStep = false;
+        if (levelTime / levelFrames > meanBeforeStep * MIN_IMPROVEMENT) {
+            lowestUseful = level - 1;
+            return SetLevel(level - 1);
+        }
+    }
+
+    if (average > budget * OVER_BUDGET) {
+        // Frames just got slow: measure this level afresh, so a step down is judged against
+        // how slow it is now rather than how fast it used to be
+        if (overTime == 0.0f && !verifyingStep) {
+            levelTime = sample;
+            levelFrames = 1;
+        }
+        overTime += frameSeconds;
+        underTime = 0.0f;
+    } else if (average < budget * WITHIN_BUDGET) {
+        underTime += frameSeconds;
+        overTime = 0.0f;
+        lowestUseful = LEVEL_COUNT - 1;  // Whatever blocked stepping down may have changed
+    } else {
+        overTime = 0.0f;
+        underTime = 0.0f;
+    }
+
+    if (overTime >= STEP_DOWN_DELAY && level < lowestUseful && !verifyingStep) {
+        if (sinceStepUp < REVERT_WINDOW) {
+            upDelay = std::min(MAX_UP_DELAY, upDelay * 2.0f);
+            sinceStepUp = REVERT_WINDOW;  // Already paid for; don't also earn it back
+        }
+        verifyingStep = true;
+        meanBeforeStep = levelTime / levelFrames;
+        return SetLevel(level + 1);
+    }
+    if (underTime >= upDelay && level > 0) {
+        sinceStepUp = 0.0f;
+        return SetLevel(level - 1);
+    }
+    return false;
+}
+
+bool ResolutionScaler::SetLevel(int newLevel) {
+    newLevel = std::max(0, std::min(LEVEL_COUNT - 1, newLevel));
+    if (newLevel == level) {
+        return false;
+    }
+    level = newLevel;
+    overTime = 0.0f;
+    underTime = 0.0f;
+    levelTime = 0.0f;
+    levelFrames = 0;
+    settleTime = SETTLE_TIME;
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Picks the internal render scale from measured frame times, to hold the frame budget on slow
+// devices. Frame times are smoothed; an average over the budget for a while steps the scale
+// down, and an average back within the budget for longer steps it up again. The gap between
+// the two thresholds and the two delays keeps it from oscillating, and a step up that has to
+// be taken back soon after doubles the wait before the next one. A step down that doesn't
+// make frames faster (say, a display refreshing slower than the budget) is undone, and no
+// further steps down are tried until frames are back within the budget.
+class ResolutionScaler
+{
+public:
+    static const int LEVEL_COUNT = 5;
+
+    explicit ResolutionScaler(float budgetSeconds);
+
+    bool Update(float frameSeconds);  // Feed one frame's time; true when Scale() has changed
+    float Scale() const { return LEVELS[level]; }  // Render resolution over the full resolution
+    int Level() const { return level; }            // 0 is full resolution
+    float AverageFrameTime() const { return average; }
+
+private:
+    static const float LEVELS[LEVEL_COUNT];
+
+    bool SetLevel(int newLevel);
+
+    float budget;
+    int level;
+    int lowestUseful;        // Deepest level steps down may reach for now
+    float average;           // Smoothed frame time
+    float overTime;          // Seconds the average has been over the budget
+    float underTime;         // Seconds it has been within the budget
+    float settleTime;        // Seconds left before frames count again after a change
+    float sinceStepUp;
+    float upDelay;           // Seconds within the budget needed before stepping up
+    bool verifyingStep;      // The last step was down and hasn't yet been shown to help
+    float levelTime;         // Frame time counted at this level (or since it got slow), for its mean
+    int levelFrames;
+    float meanBeforeStep;    // Mean frame time at the level stepped down from
+};
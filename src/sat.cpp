@@ -0,0 +1,456 @@
+#include <algorithm>
+
+#include "sat.h"
+
+namespace {
+    const double ACTIVITY_DECAY = 0.95;
+    const int RESTART_BASE = 100;       // Conflicts in the first restart interval
+    const int INITIAL_MAX_LEARNTS = 20000;
+    const int SATISFIED_REDUCE_MIN = 256;
+
+    // 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, ... restart schedule
+    int Luby(int i) {
+        int size = 1;
+        int seq = 0;
+        while (size < i + 1) {
+            seq++;
+            size = 2 * size + 1;
+        }
+        int x = i;
+        while (size - 1 != x) {
+            size = (size - 1) >> 1;
+            seq--;
+            x = x % size;
+        }
+        return 1 << seq;
+    }
+}
+
+SatSolver::SatSolver() {
+    Clear();
+}
+
+void SatSolver::Clear() {
+    ok = true;
+    clauses.clear();
+    watches.clear();
+    assigns.clear();
+    levels.clear();
+    reasons.clear();
+    polarity.clear();
+    seen.clear();
+    trail.clear();
+    trailLimits.clear();
+    propagateHead = 0;
+    model.clear();
+    activity.clear();
+    activityIncrement = 1.0;
+    heap.clear();
+    heapIndex.clear();
+    learntCount = 0;
+    maxLearnts = INITIAL_MAX_LEARNTS;
+    satisfiedSinceReduce = 0;
+}
+
+int SatSolver::NewVar() {
+    int var = (int)assigns.size();
+    assigns.push_back(-1);
+    levels.push_back(0);
+    reasons.push_back(-1);
+    polarity.push_back(0);  // Try false first; most cells are not mines
+    seen.push_back(0);
+    activity.push_back(0.0);
+    heapIndex.push_back(-1);
+    watches.emplace_back();
+    watches.emplace_back();
+    model.push_back(0);
+    HeapInsert(var);
+    return var;
+}
+
+int SatSolver::LitValue(int lit) const {
+    signed char value = assigns[LitVar(lit)];
+    return value < 0 ? -1 : value ^ (lit & 1);
+}
+
+int SatSolver::FixedValue(int var) const {
+    if (assigns[var] < 0 || levels[var] != 0) {
+        return -1;
+    }
+    return assigns[var];
+}
+
+void SatSolver::Enqueue(int lit, int reason) {
+    int var = LitVar(lit);
+    assigns[var] = (lit & 1) ? 0 : 1;
+    levels[var] = DecisionLevel();
+    reasons[var] = reason;
+    trail.push_back(lit);
+    if (DecisionLevel() == 0) {
+        satisfiedSinceReduce++;
+    }
+}
+
+void SatSolver::Attach(int clause) {
+    const std::vector<int>& lits = clauses[clause].lits;
+    watches[lits[0]].push_back(clause);
+    watches[lits[1]].push_back(clause);
+}
+
+bool SatSolver::AddClause(std::vector<int> lits) {
+    if (!ok) {
+        return false;
+    }
+    Backtrack(0);
+
+    // Drop duplicates and literals already false; a true or complementary literal satisfies it
+    std::sort(lits.begin(), lits.end());
+    int size = 0;
+    for (size_t i = 0; i < lits.size(); ++i) {
+        int value = LitValue(lits[i]);
+        if (value == 1 || (i > 0 && lits[i] == (lits[i - 1] ^ 1))) {
+            return true;
+        }
+        if (value == 0 || (size > 0 && lits[size - 1] == lits[i])) {
+            continue;
+        }
+        lits[size++] = lits[i];
+    }
+    lits.resize(size);
+
+    if (lits.empty()) {
+        ok = false;
+        return false;
+    }
+    if (lits.size() == 1) {
+        Enqueue(lits[0], -1);
+        ok = Propagate() < 0;
+        return ok;
+    }
+    clauses.push_back({ lits, false, false });
+    Attach((int)clauses.size() - 1);
+    return true;
+}
+
+int SatSolver::Propagate() {
+    while (propagateHead < (int)trail.size()) {
+        int falseLit = trail[propagateHead++] ^ 1;
+        std::vector<int>& watching = watches[falseLit];
+
+        size_t keep = 0;
+        for (size_t i = 0; i < watching.size(); ++i) {
+            int clause = watching[i];
+            std::vector<int>& lits = clauses[clause].lits;
+            if (lits[0] == falseLit) {
+                std::swap(lits[0], lits[1]);
+            }
+            if (LitValue(lits[0]) == 1) {
+                watching[keep++] = clause;
+                continue;
+            }
+
+            // Look for another literal to watch
+            bool moved = false;
+            for (size_t k = 2; k < lits.size(); ++k) {
+                if (LitValue(lits[k]) != 0) {
+                    std::swap(lits[1], lits[k]);
+                    watches[lits[1]].push_back(clause);
+                    moved = true;
+                    break;
+                }
+            }
+            if (moved) {
+                continue;
+            }
+
+            watching[keep++] = clause;
+            if (LitValue(lits[0]) == 0) {
+                // Conflict: keep the remaining watches and stop
+                for (++i; i < watching.size(); ++i) {
+                    watching[keep++] = watching[i];
+                }
+                watching.resize(keep);
+                propagateHead = (int)trail.size();
+                return clause;
+            }
+            Enqueue(lits[0], clause);
+        }
+        watching.resize(keep);
+    }
+    return -1;
+}
+
+void SatSolver::Analyze(int conflict, std::vector<int>& learnt, int& backtrackLevel) {
+    learnt.assign(1, -1);  // Slot for the asserting literal
+    int pathCount = 0;
+    int lit = -1;
+    int index = (int)trail.size() - 1;
+    int clause = conflict;
+
+    do {
+        const std::vector<int>& lits = clauses[clause].lits;
+        for (size_t i = (lit == -1 ? 0 : 1); i < lits.size(); ++i) {
+            int var = LitVar(lits[i]);
+            if (seen[var] || levels[var] == 0) continue;
+            BumpActivity(var);
+            seen[var] = 1;
+            if (levels[var] >= DecisionLevel()) {
+                pathCount++;
+            } else {
+                learnt.push_back(lits[i]);
+            }
+        }
+
+        // Walk back to the next marked literal of the current level
+        while (!seen[LitVar(trail[index])]) {
+            index--;
+        }
+        lit = trail[index--];
+        clause = reasons[LitVar(lit)];
+        seen[LitVar(lit)] = 0;
+        pathCount--;
+    } while (pathCount > 0);
+    learnt[0] = lit ^ 1;
+
+    // Backtrack to the second highest level, with that literal watched next to the asserting one
+    backtrackLevel = 0;
+    int maxIndex = 1;
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        if (levels[LitVar(learnt[i])] > backtrackLevel) {
+            backtrackLevel = levels[LitVar(learnt[i])];
+            maxIndex = (int)i;
+        }
+    }
+    if (learnt.size() > 1) {
+        std::swap(learnt[1], learnt[maxIndex]);
+    }
+    for (size_t i = 1; i < learnt.size(); ++i) {
+        seen[LitVar(learnt[i])] = 0;
+    }
+}
+
+void SatSolver::Backtrack(int level) {
+    if (DecisionLevel() <= level) {
+        return;
+    }
+    for (int i = (int)trail.size() - 1; i >= trailLimits[level]; --i) {
+        int var = LitVar(trail[i]);
+        polarity[var] = assigns[var];
+        assigns[var] = -1;
+        reasons[var] = -1;
+        if (heapIndex[var] < 0) {
+            HeapInsert(var);
+        }
+    }
+    trail.resize(trailLimits[level]);
+    trailLimits.resize(level);
+    propagateHead = (int)trail.size();
+}
+
+int SatSolver::PickBranchLit() {
+    while (!heap.empty()) {
+        int var = HeapPop();
+        if (assigns[var] < 0) {
+            return polarity[var] ? PosLit(var) : NegLit(var);
+        }
+    }
+    return -1;
+}
+
+void SatSolver::ReduceClauses() {
+    // Cleaning costs a pass over every clause, so wait until enough has been fixed
+    bool removeSatisfied = satisfiedSinceReduce > SATISFIED_REDUCE_MIN + VarCount() / 16;
+    bool removeLearnts = learntCount > maxLearnts;
+    if (!removeSatisfied && !removeLearnts) {
+        return;
+    }
+
+    if (removeLearnts) {
+        // Keep the shorter half of the learnt clauses
+        std::vector<int> lengths;
+        for (const Clause& clause : clauses) {
+            if (clause.learnt) {
+                lengths.push_back((int)clause.lits.size());
+            }
+        }
+        std::nth_element(lengths.begin(), lengths.begin() + lengths.size() / 2, lengths.end());
+        int cutoff = lengths[lengths.size() / 2];
+        for (Clause& clause : clauses) {
+            if (clause.learnt && (int)clause.lits.size() > cutoff) {
+                clause.deleted = true;
+            }
+        }
+        maxLearnts += maxLearnts / 10;
+    }
+    // Drop clauses satisfied at level 0 and strip false literals from the rest, so no clause
+    // ends up watching a literal that will never be propagated again
+    for (Clause& clause : clauses) {
+        size_t size = 0;
+        for (size_t i = 0; i < clause.lits.size() && !clause.deleted; ++i) {
+            int value = LitValue(clause.lits[i]);
+            if (value == 1) {
+                clause.deleted = true;
+            } else if (value == -1) {
+                clause.lits[size++] = clause.lits[i];
+            }
+        }
+        clause.lits.resize(size);
+    }
+
+    // Compact, then rebuild the watch lists; level-0 reasons are never looked at again
+    size_t keep = 0;
+    learntCount = 0;
+    for (size_t i = 0; i < clauses.size(); ++i) {
+        if (!clauses[i].deleted) {
+            learntCount += clauses[i].learnt ? 1 : 0;
+            if (keep != i) {
+                clauses[keep] = std::move(clauses[i]);
+            }
+            keep++;
+        }
+    }
+    clauses.resize(keep);
+    for (std::vector<int>& watching : watches) {
+        watching.clear();
+    }
+    for (int i = 0; i < (int)clauses.size(); ++i) {
+        Attach(i);
+    }
+    for (int lit : trail) {
+        reasons[LitVar(lit)] = -1;
+    }
+    satisfiedSinceReduce = 0;
+}
+
+SatResult SatSolver::Solve(const std::vector<int>& assumptions) {
+    if (!ok) {
+        return SatResult::UNSAT;
+    }
+    Backtrack(0);
+    ReduceClauses();
+
+    int restarts = 0;
+    int conflictsLeft = Luby(restarts) * RESTART_BASE;
+    std::vector<int> learnt;
+
+    for (;;) {
+        int conflict = Propagate();
+        if (conflict >= 0) {
+            if (DecisionLevel() == 0) {
+                ok = false;
+                return SatResult::UNSAT;
+            }
+            int backtrackLevel;
+            Analyze(conflict, learnt, backtrackLevel);
+            Backtrack(backtrackLevel);
+            if (learnt.size() == 1) {
+                Enqueue(learnt[0], -1);  // Backtrack level is 0 here
+            } else {
+                clauses.push_back({ learnt, true, false });
+                learntCount++;
+                Attach((int)clauses.size() - 1);
+                Enqueue(learnt[0], (int)clauses.size() - 1);
+            }
+            activityIncrement /= ACTIVITY_DECAY;
+            conflictsLeft--;
+            continue;
+        }
+
+        if (conflictsLeft <= 0) {
+            Backtrack(0);
+            conflictsLeft = Luby(++restarts) * RESTART_BASE;
+            continue;
+        }
+
+        // Assumptions are the first decisions; one that is already false means UNSAT under them
+        int next = -1;
+        while (DecisionLevel() < (int)assumptions.size()) {
+            int lit = assumptions[DecisionLevel()];
+            int value = LitValue(lit);
+            if (value == 1) {
+                trailLimits.push_back((int)trail.size());  // Keep levels aligned with assumptions
+            } else if (value == 0) {
+                Backtrack(0);
+                return SatResult::UNSAT;
+            } else {
+                next = lit;
+                break;
+            }
+        }
+        if (next < 0) {
+            next = PickBranchLit();
+            if (next < 0) {
+                for (int var = 0; var < VarCount(); ++var) {
+                    model[var] = assigns[var] == 1;
+                }
+                Backtrack(0);
+                return SatResult::SAT;
+            }
+        }
+        trailLimits.push_back((int)trail.size());
+        Enqueue(next, -1);
+    }
+}
+
+void SatSolver::BumpActivity(int var) {
+    activity[var] += activityIncrement;
+    if (activity[var] > 1e100) {
+        for (double& value : activity) {
+            value *= 1e-100;
+        }
+        activityIncrement *= 1e-100;
+    }
+    if (heapIndex[var] >= 0) {
+        HeapUp(heapIndex[var]);
+    }
+}
+
+void SatSolver::HeapInsert(int var) {
+    heapIndex[var] = (int)heap.size();
+    heap.push_back(var);
+    HeapUp(heapIndex[var]);
+}
+
+int SatSolver::HeapPop() {
+    int top = heap[0];
+    heapIndex[top] = -1;
+    int last = heap.back();
+    heap.pop_back();
+    if (!heap.empty()) {
+        heap[0] = last;
+        heapIndex[last] = 0;
+        HeapDown(0);
+    }
+    return top;
+}
+
+void SatSolver::HeapUp(int pos) {
+    int var = heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (activity[heap[parent]] >= activity[var]) break;
+        heap[pos] = heap[parent];
+        heapIndex[heap[pos]] = pos;
+        pos = parent;
+    }
+    heap[pos] = var;
+    heapIndex[var] = pos;
+}
+
+void SatSolver::HeapDown(int pos) {
+    int var = heap[pos];
+    int size = (int)heap.size();
+    for (;;) {
+        int child = 2 * pos + 1;
+        if (child >= size) break;
+        if (child + 1 < size && activity[heap[child + 1]] > activity[heap[child]]) {
+            child++;
+        }
+        if (activity[heap[child]] <= activity[var]) break;
+        heap[pos] = heap[child];
+        heapIndex[heap[pos]] = pos;
+        pos = child;
+    }
+    heap[pos] = var;
+    heapIndex[var] = pos;
+}
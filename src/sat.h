@@ -0,0 +1,80 @@
+#pragma once
+
+#include <vector>
+
+// Literals are 2 * var for "var is true" and 2 * var + 1 for "var is false"
+inline int PosLit(int var) { return var * 2; }
+inline int NegLit(int var) { return var * 2 + 1; }
+inline int LitVar(int lit) { return lit >> 1; }
+
+enum class SatResult {
+    SAT,
+    UNSAT
+};
+
+// Small CDCL SAT solver: two watched literals, first-UIP learning, VSIDS branching with
+// phase saving, and Luby restarts. It is incremental: clauses and learnt clauses persist
+// between calls, and each Solve can assume extra literals without adding them for good.
+class SatSolver
+{
+public:
+    SatSolver();
+
+    void Clear();
+    int NewVar();
+    int VarCount() const { return (int)assigns.size(); }
+    int ClauseCount() const { return (int)clauses.size(); }
+
+    // Returns false once the clauses can no longer be satisfied
+    bool AddClause(std::vector<int> lits);
+    SatResult Solve(const std::vector<int>& assumptions);
+
+    bool ModelValue(int var) const { return model[var] != 0; }  // Valid after Solve returned SAT
+    int FixedValue(int var) const;  // 1 or 0 if implied by the clauses alone, -1 otherwise
+
+private:
+    struct Clause {
+        std::vector<int> lits;
+        bool learnt;
+        bool deleted;
+    };
+
+    int LitValue(int lit) const;  // 1 true, 0 false, -1 unassigned
+    int DecisionLevel() const { return (int)trailLimits.size(); }
+    void Enqueue(int lit, int reason);
+    int Propagate();  // Returns the conflicting clause, or -1
+    void Analyze(int conflict, std::vector<int>& learnt, int& backtrackLevel);
+    void Backtrack(int level);
+    int PickBranchLit();
+    void Attach(int clause);
+    void ReduceClauses();
+
+    // VSIDS order
+    void BumpActivity(int var);
+    void HeapInsert(int var);
+    int HeapPop();
+    void HeapUp(int pos);
+    void HeapDown(int pos);
+
+    bool ok;
+    std::vector<Clause> clauses;
+    std::vector<std::vector<int>> watches;  // Per literal: clauses watching it
+    std::vector<signed char> assigns;       // Per var: -1 unassigned, 0 false, 1 true
+    std::vector<int> levels;
+    std::vector<int> reasons;               // Clause that implied each var, -1 for decisions
+    std::vector<char> polarity;             // Saved phase
+    std::vector<char> seen;
+    std::vector<int> trail;
+    std::vector<int> trailLimits;
+    int propagateHead;
+    std::vector<char> model;
+
+    std::vector<double> activity;
+    double activityIncrement;
+    std::vector<int> heap;
+    std::vector<int> heapIndex;             // Position of each var in heap, -1 if absent
+
+    int learntCount;
+    int maxLearnts;
+    int satisfiedSinceReduce;               // Level-0 assignments since clauses were last cleaned
+};
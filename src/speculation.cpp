@@ -0,0 +1,154 @@
+#include "speculation.h"
+
+SpeculativeReveal::SpeculativeReveal()
+    : active(false), done(false), targetRow(-1), targetCol(-1), targetChord(false),
+      boardVersion(0), safeCells(0), stamp(0)
+{
+    plan.outcome = RevealOutcome::NONE;
+}
+
+void SpeculativeReveal::Invalidate() {
+    active = false;
+    done = false;
+    targetRow = -1;
+    targetCol = -1;
+}
+
+bool SpeculativeReveal::IsTarget(int row, int col, bool chord) const {
+    return active && targetRow == row && targetCol == col && targetChord == chord;
+}
+
+bool SpeculativeReveal::IsReadyFor(const Board& board, int row, int col, bool chord) const {
+    return done && IsTarget(row, col, chord) && boardVersion == board.Version();
+}
+
+void SpeculativeReveal::Mark(int index) {
+    marks[index] = stamp;
+}
+
+void SpeculativeReveal::Begin(const Board& board, int row, int col, bool chord) {
+    active = true;
+    done = false;
+    targetRow = row;
+    targetCol = col;
+    targetChord = chord;
+    boardVersion = board.Version();
+
+    plan.cells.clear();
+    plan.outcome = RevealOutcome::NONE;
+    safeCells = 0;
+    worklist.clear();
+
+    // A new stamp clears every mark at once; only wipe the array when the stamp wraps
+    int cellCount = board.Rows() * board.Cols();
+    if ((int)marks.size() != cellCount || ++stamp == 0) {
+        marks.assign(cellCount, 0);
+        stamp = 1;
+    }
+
+    if (!board.IsValidCell(row, col)) {
+        Finish(RevealOutcome::NONE);
+        return;
+    }
+
+    const Cell& cell = board.At(row, col);
+    if (!chord) {
+        if (cell.state != CellState::HIDDEN) {
+            Finish(RevealOutcome::NONE);
+        } else if (cell.hasMine) {
+            plan.cells.push_back(board.Index(row, col));
+            Finish(RevealOutcome::HIT_MINE);
+        } else {
+            Mark(board.Index(row, col));
+            worklist.push_back(board.Index(row, col));
+        }
+        return;
+    }
+
+    // Chord: same checks as Board::RevealAdjacentCells
+    if (cell.state != CellState::REVEALED || cell.hasMine) {
+        Finish(RevealOutcome::NONE);
+        return;
+    }
+
+    if (cell.flaggedNeighbors != cell.adjacentMines) {
+        Finish(RevealOutcome::NONE);
+        return;
+    }
+    bool mistakeMade = cell.misflaggedNeighbors > 0;
+
+    for (int dr = -1; dr <= 1; ++dr) {
+        for (int dc = -1; dc <= 1; ++dc) {
+            if ((dr == 0 && dc == 0) || !board.IsValidCell(row + dr, col + dc)) continue;
+            int index = board.Index(row + dr, col + dc);
+            const Cell& neighbor = board.At(row + dr, col + dc);
+            if (mistakeMade) {
+                // A wrong flag reveals the neighboring mines and ends the game
+                if (neighbor.hasMine) {
+                    plan.cells.push_back(index);
+                }
+            } else if (neighbor.state == CellState::HIDDEN) {
+                Mark(index);
+                worklist.push_back(index);
+            }
+        }
+    }
+    if (mistakeMade) {
+        Finish(RevealOutcome::HIT_MINE);
+    }
+}
+
+bool SpeculativeReveal::Step(const Board& board, int budget) {
+    if (!active) {
+        return false;
+    }
+    if (board.Version() != boardVersion) {
+        // The board changed under us, so start over from the current state
+        Begin(board, targetRow, targetCol, targetChord);
+    }
+    if (done) {
+        return true;
+    }
+
+    int cols = board.Cols();
+    while (!worklist.empty() && budget-- > 0) {
+        int index = worklist.back();
+        worklist.pop_back();
+        plan.cells.push_back(index);
+        safeCells++;
+
+        const Cell& cell = board.At(index / cols, index % cols);
+        if (cell.adjacentMines != 0) {
+            continue;
+        }
+
+        int row = index / cols;
+        int col = index % cols;
+        for (int dr = -1; dr <= 1; ++dr) {
+            for (int dc = -1; dc <= 1; ++dc) {
+                int newRow = row + dr;
+                int newCol = col + dc;
+                if (!board.IsValidCell(newRow, newCol)) continue;
+                int newIndex = board.Index(newRow, newCol);
+                if (board.At(newRow, newCol).state == CellState::HIDDEN && !IsMarked(newIndex)) {
+                    Mark(newIndex);
+                    worklist.push_back(newIndex);
+                }
+            }
+        }
+    }
+
+    if (worklist.empty()) {
+        if (safeCells == 0) {
+            Finish(RevealOutcome::NONE);
+        } else {
+            Finish(safeCells == board.RemainingCells() ? RevealOutcome::WON : RevealOutcome::REVEALED);
+        }
+    }
+    return done;
+}
+
+void SpeculativeReveal::Finish(RevealOutcome outcome) {
+    plan.outcome = outcome;
+    done = true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "board.h"
+
+// Works out what revealing (or chording) one cell would do, a slice at a time, so the plan
+// for the cell under the mouse is ready before the click and can be committed right away.
+// The plan is only valid for the board version it was computed against.
+class SpeculativeReveal
+{
+public:
+    SpeculativeReveal();
+
+    void Begin(const Board& board, int row, int col, bool chord);
+    bool Step(const Board& board, int budget);  // Process up to "budget" cells; true once the plan is complete
+    void Invalidate();
+
+    bool IsTarget(int row, int col, bool chord) const;
+    bool IsReadyFor(const Board& board, int row, int col, bool chord) const;
+    const RevealPlan& Plan() const { return plan; }
+
+private:
+    void Finish(RevealOutcome outcome);
+    void Mark(int index);
+    bool IsMarked(int index) const { return marks[index] == stamp; }
+
+    bool active;
+    bool done;
+    int targetRow;
+    int targetCol;
+    bool targetChord;
+    unsigned int boardVersion;
+
+    RevealPlan plan;
+    int safeCells;                   // Safe cells in the plan so far
+    std::vector<int> worklist;
+    std::vector<unsigned int> marks; // Cells already in the plan, valid where marks[i] == stamp
+    unsigned int stamp;
+};
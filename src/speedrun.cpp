@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#include "speedrun.h"
+
+SpeedrunTimer::SpeedrunTimer()
+    : levelRunning(false), finished(false), levelStartNs(0), lastLevelNs(0), completedNs(0)
+{
+}
+
+int64_t SpeedrunTimer::NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void SpeedrunTimer::Reset() {
+    levelRunning = false;
+    finished = false;
+    levelStartNs = 0;
+    lastLevelNs = 0;
+    completedNs = 0;
+    splits.clear();
+    moveTimes.clear();
+}
+
+void SpeedrunTimer::ResetLevel() {
+    levelRunning = false;
+    lastLevelNs = 0;
+}
+
+void SpeedrunTimer::RecordMove(int64_t timestampNs) {
+    if (finished) {
+        return;
+    }
+    if (!levelRunning) {
+        levelRunning = true;
+        levelStartNs = timestampNs;
+    }
+    moveTimes.push_back(RunTimeNs(timestampNs));
+}
+
+void SpeedrunTimer::FinishLevel(int gridSize, int64_t timestampNs, bool finalLevel) {
+    if (!levelRunning) {
+        return;
+    }
+
+    int64_t levelNs = timestampNs - levelStartNs;
+    completedNs += levelNs;
+    splits.push_back({ gridSize, levelNs, completedNs });
+    lastLevelNs = levelNs;
+    levelRunning = false;
+    finished = finalLevel;
+}
+
+int64_t SpeedrunTimer::LevelTimeNs(int64_t nowNs) const {
+    return levelRunning ? nowNs - levelStartNs : lastLevelNs;
+}
+
+int64_t SpeedrunTimer::RunTimeNs(int64_t nowNs) const {
+    return completedNs + (levelRunning ? nowNs - levelStartNs : 0);
+}
+
+std::string SpeedrunTimer::FormatTime(int64_t ns) {
+    long long totalMs = ns / 1000000;
+    long long minutes = totalMs / 60000;
+    long long seconds = (totalMs / 1000) % 60;
+    long long millis = totalMs % 1000;
+
+    char text[32];
+    if (minutes > 0) {
+        snprintf(text, sizeof(text), "%lld:%02lld.%03lld", minutes, seconds, millis);
+    } else {
+        snprintf(text, sizeof(text), "%lld.%03lld", seconds, millis);
+    }
+    return text;
+}
+
+bool SpeedrunTimer::SaveToFile(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+#ifdef DEBUG
+        std::cerr << "Failed to open speedrun file for saving: " << filename << std::endl;
+#endif
+        return false;
+    }
+
+    for (const Split& split : splits) {
+        file << split.gridSize << "x" << split.gridSize << " " << FormatTime(split.levelNs) << " "
+             << FormatTime(split.runNs) << std::endl;
+    }
+    file << "moves " << moveTimes.size() << std::endl;
+    for (int64_t moveNs : moveTimes) {
+        file << moveNs << std::endl;  // Run time in ns, so gaps between moves stay exact
+    }
+    return file.good();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Speedrun timing on a monotonic nanosecond clock, so results don't depend on the frame rate.
+// Each level is timed from its first move to the winning reveal; the run time is the sum of
+// the level times, so the pause between levels doesn't count. A won level keeps showing its
+// time until the next one starts.
+class SpeedrunTimer
+{
+public:
+    struct Split {
+        int gridSize;
+        int64_t levelNs;  // Time spent on this level
+        int64_t runNs;    // Run time when the level was won
+    };
+
+    SpeedrunTimer();
+
+    static int64_t NowNs();  // Monotonic clock, used to stamp input events
+
+    void Reset();        // Forget the whole run
+    void ResetLevel();   // Start the current level over without touching completed splits
+    void RecordMove(int64_t timestampNs);  // The first move of a level starts its timer
+    void FinishLevel(int gridSize, int64_t timestampNs, bool finalLevel);
+
+    bool IsLevelRunning() const { return levelRunning; }
+    bool IsFinished() const { return finished; }
+    int64_t LevelTimeNs(int64_t nowNs) const;
+    int64_t RunTimeNs(int64_t nowNs) const;
+    const std::vector<Split>& Splits() const { return splits; }
+    const std::vector<int64_t>& MoveTimes() const { return moveTimes; }  // Run time of every move
+
+    static std::string FormatTime(int64_t ns);  // "s.mmm" or "m:ss.mmm"
+
+    // Writes a line per split ("9x9 4.215 12.803": size, level time, run time), then
+    // "moves N" and the run time in ns of each of the N moves, one per line
+    bool SaveToFile(const std::string& filename) const;
+
+private:
+    bool levelRunning;
+    bool finished;
+    int64_t levelStartNs;
+    int64_t lastLevelNs;  // Time of the level just won, shown until the next one starts
+    int64_t completedNs;  // Sum of the finished level times
+    std::vector<Split> splits;
+    std::vector<int64_t> moveTimes;
+};
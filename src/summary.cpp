@@ -0,0 +1,238 @@
+#include <algorithm>
+
+#include "summary.h"
+#include "board.h"
+#include "parallel.h"
+
+const int BoardSummary::TILE_SIZE;
+
+namespace {
+    const int TILE_SHIFT = 3;    // Tiles are 8x8 cells
+    const int LEVEL_SHIFT = 3;   // Each level groups 8x8 units of the one below
+    const int BLOCK_LEVELS = 2;  // 64x64 blocks and 512x512 superblocks above the tiles
+    const uint64_t TILE_COLUMN = 0x0101010101010101ULL;  // Bit 0 of every tile row
+
+    inline uint64_t Bit(int row, int col) {
+        return 1ULL << (((row & 7) << 3) | (col & 7));
+    }
+}
+
+void BoardSummary::Build(const Board& board) {
+    rows = board.Rows();
+    cols = board.Cols();
+    int tileCols = (cols + BoardSummary::TILE_SIZE - 1) >> TILE_SHIFT;
+    int tileRows = (rows + BoardSummary::TILE_SIZE - 1) >> TILE_SHIFT;
+    levels.resize(BLOCK_LEVELS);
+    for (int i = 0; i < BLOCK_LEVELS; ++i) {
+        Level& level = levels[i];
+        level.shift = TILE_SHIFT + LEVEL_SHIFT * (i + 1);
+        level.width = (cols + (1 << level.shift) - 1) >> level.shift;
+        level.height = (rows + (1 << level.shift) - 1) >> level.shift;
+        level.counts.assign(level.width * level.height, { 0, 0, 0 });
+    }
+    int tileSlots = (int)levels[0].counts.size() << (2 * LEVEL_SHIFT);
+    hiddenBits.assign(tileSlots, 0);
+    flaggedBits.assign(tileSlots, 0);
+    mineBits.assign(tileSlots, 0);
+
+    // Stripes are whole tile rows, so each tile is written by exactly one stripe
+    ParallelFor(StripeCount(rows), [&](int stripe) {
+        int rowEnd = std::min(rows, (stripe + 1) * STRIPE_ROWS);
+        board.ForEachCellIn(stripe * STRIPE_ROWS, rowEnd, 0, cols, [&](int row, int col, const Cell& cell) {
+            int slot = TileSlot(row >> TILE_SHIFT, col >> TILE_SHIFT);
+            uint64_t bit = Bit(row, col);
+            if (cell.state == CellState::HIDDEN) hiddenBits[slot] |= bit;
+            if (cell.state == CellState::FLAGGED) flaggedBits[slot] |= bit;
+            if (cell.hasMine) mineBits[slot] |= bit;
+        });
+    });
+
+    for (int tileRow = 0; tileRow < tileRows; ++tileRow) {
+        for (int tileCol = 0; tileCol < tileCols; ++tileCol) {
+            int slot = TileSlot(tileRow, tileCol);
+            Level& blocks = levels[0];
+            SummaryCounts& to = blocks.counts[(tileRow >> LEVEL_SHIFT) * blocks.width + (tileCol >> LEVEL_SHIFT)];
+            to.hidden += __builtin_popcountll(hiddenBits[slot]);
+            to.flagged += __builtin_popcountll(flaggedBits[slot]);
+            to.mines += __builtin_popcountll(mineBits[slot]);
+        }
+    }
+    for (int i = 1; i < BLOCK_LEVELS; ++i) {
+        const Level& below = levels[i - 1];
+        Level& level = levels[i];
+        for (int unitRow = 0; unitRow < below.height; ++unitRow) {
+            for (int unitCol = 0; unitCol < below.width; ++unitCol) {
+                const SummaryCounts& from = below.counts[unitRow * below.width + unitCol];
+                SummaryCounts& to = level.counts[(unitRow >> LEVEL_SHIFT) * level.width + (unitCol >> LEVEL_SHIFT)];
+                to.hidden += from.hidden;
+                to.flagged += from.flagged;
+                to.mines += from.mines;
+            }
+        }
+    }
+}
+
+bool BoardSummary::Clip(int rowBegin, int rowEnd, int colBegin, int colEnd, Region& region) const {
+    region.rowBegin = std::max(rowBegin, 0);
+    region.rowEnd = std::min(rowEnd, rows);
+    region.colBegin = std::max(colBegin, 0);
+    region.colEnd = std::min(colEnd, cols);
+    return region.rowBegin < region.rowEnd && region.colBegin < region.colEnd;
+}
+
+uint64_t BoardSummary::TileMask(int tileRow, int tileCol, const Region& region) const {
+    int rowBegin = std::max(region.rowBegin - (tileRow << TILE_SHIFT), 0);
+    int rowEnd = std::min(region.rowEnd - (tileRow << TILE_SHIFT), TILE_SIZE);
+    int colBegin = std::max(region.colBegin - (tileCol << TILE_SHIFT), 0);
+    int colEnd = std::min(region.colEnd - (tileCol << TILE_SHIFT), TILE_SIZE);
+    if (rowBegin >= rowEnd || colBegin >= colEnd) {
+        return 0;
+    }
+    uint64_t colBits = ((1ULL << (colEnd - colBegin)) - 1) << colBegin;
+    int rowCount = rowEnd - rowBegin;
+    uint64_t rowBits = (rowCount == TILE_SIZE ? ~0ULL : (1ULL << (rowCount * TILE_SIZE)) - 1) << (rowBegin * TILE_SIZE);
+    return rowBits & (TILE_COLUMN * colBits);
+}
+
+void BoardSummary::FullUnits(const Region& region, int shift, int& rowBegin, int& rowEnd, int& colBegin, int& colEnd) const {
+    // Units at the bottom and right edges of the board are clipped, so they count as whole
+    // when the region reaches the board's edge
+    int size = 1 << shift;
+    rowBegin = (region.rowBegin + size - 1) >> shift;
+    rowEnd = region.rowEnd == rows ? (rows + size - 1) >> shift : region.rowEnd >> shift;
+    colBegin = (region.colBegin + size - 1) >> shift;
+    colEnd = region.colEnd == cols ? (cols + size - 1) >> shift : region.colEnd >> shift;
+}
+
+int BoardSummary::CountUnit(int level, int unitRow, int unitCol, const Region& region,
+                            int SummaryCounts::*field, const std::vector<uint64_t>& bits) const {
+    if (level == 0) {
+        return __builtin_popcountll(bits[TileSlot(unitRow, unitCol)] & TileMask(unitRow, unitCol, region));
+    }
+
+    const Level& current = levels[level - 1];
+    int shift = current.shift;
+    Region unit = { unitRow << shift, std::min(rows, (unitRow + 1) << shift),
+                    unitCol << shift, std::min(cols, (unitCol + 1) << shift) };
+    Region overlap = { std::max(unit.rowBegin, region.rowBegin), std::min(unit.rowEnd, region.rowEnd),
+                       std::max(unit.colBegin, region.colBegin), std::min(unit.colEnd, region.colEnd) };
+    if (overlap.rowBegin >= overlap.rowEnd || overlap.colBegin >= overlap.colEnd) {
+        return 0;
+    }
+    const SummaryCounts& counts = current.counts[unitRow * current.width + unitCol];
+    if (counts.*field == 0) {
+        return 0;
+    }
+    if (overlap.rowBegin == unit.rowBegin && overlap.rowEnd == unit.rowEnd &&
+        overlap.colBegin == unit.colBegin && overlap.colEnd == unit.colEnd) {
+        return counts.*field;
+    }
+
+    // Children wholly inside the region are added directly; only the edge ones recurse
+    int total = 0;
+    int childShift = shift - LEVEL_SHIFT;
+    int fullRowBegin, fullRowEnd, fullColBegin, fullColEnd;
+    FullUnits(region, childShift, fullRowBegin, fullRowEnd, fullColBegin, fullColEnd);
+    for (int childRow = overlap.rowBegin >> childShift; childRow <= (overlap.rowEnd - 1) >> childShift; ++childRow) {
+        bool rowInside = childRow >= fullRowBegin && childRow < fullRowEnd;
+        for (int childCol = overlap.colBegin >> childShift; childCol <= (overlap.colEnd - 1) >> childShift; ++childCol) {
+            if (!rowInside || childCol < fullColBegin || childCol >= fullColEnd) {
+                total += CountUnit(level - 1, childRow, childCol, region, field, bits);
+            } else if (level == 1) {
+                total += __builtin_popcountll(bits[TileSlot(childRow, childCol)]);
+            } else {
+                const Level& below = levels[level - 2];
+                total += below.counts[childRow * below.width + childCol].*field;
+            }
+        }
+    }
+    return total;
+}
+
+int BoardSummary::Count(const Region& region, int SummaryCounts::*field, const std::vector<uint64_t>& bits) const {
+    const Level& top = levels.back();
+    int total = 0;
+    for (int unitRow = region.rowBegin >> top.shift; unitRow <= (region.rowEnd - 1) >> top.shift; ++unitRow) {
+        for (int unitCol = region.colBegin >> top.shift; unitCol <= (region.colEnd - 1) >> top.shift; ++unitCol) {
+            total += CountUnit(BLOCK_LEVELS, unitRow, unitCol, region, field, bits);
+        }
+    }
+    return total;
+}
+
+int BoardSummary::CountHidden(int rowBegin, int rowEnd, int colBegin, int colEnd) const {
+    Region region;
+    if (!Clip(rowBegin, rowEnd, colBegin, colEnd, region)) {
+        return 0;
+    }
+    return Count(region, &SummaryCounts::hidden, hiddenBits);
+}
+
+int BoardSummary::CountFlags(int rowBegin, int rowEnd, int colBegin, int colEnd) const {
+    Region region;
+    if (!Clip(rowBegin, rowEnd, colBegin, colEnd, region)) {
+        return 0;
+    }
+    return Count(region, &SummaryCounts::flagged, flaggedBits);
+}
+
+int BoardSummary::CountMines(int rowBegin, int rowEnd, int colBegin, int colEnd) const {
+    Region region;
+    if (!Clip(rowBegin, rowEnd, colBegin, colEnd, region)) {
+        return 0;
+    }
+    return Count(region, &SummaryCounts::mines, mineBits);
+}
+
+int BoardSummary::FindUnit(int level, int unitRow, int unitCol, const Region& region) const {
+    if (level == 0) {
+        uint64_t hidden = hiddenBits[TileSlot(unitRow, unitCol)] & TileMask(unitRow, unitCol, region);
+        if (hidden == 0) {
+            return -1;
+        }
+        int bit = __builtin_ctzll(hidden);
+        return ((unitRow << TILE_SHIFT) + (bit >> TILE_SHIFT)) * cols + (unitCol << TILE_SHIFT) + (bit & 7);
+    }
+
+    const Level& current = levels[level - 1];
+    if (current.counts[unitRow * current.width + unitCol].hidden == 0) {
+        return -1;
+    }
+    int shift = current.shift;
+    Region overlap = { std::max(unitRow << shift, region.rowBegin), std::min((unitRow + 1) << shift, region.rowEnd),
+                       std::max(unitCol << shift, region.colBegin), std::min((unitCol + 1) << shift, region.colEnd) };
+    if (overlap.rowBegin >= overlap.rowEnd || overlap.colBegin >= overlap.colEnd) {
+        return -1;
+    }
+    int childShift = shift - LEVEL_SHIFT;
+    for (int childRow = overlap.rowBegin >> childShift; childRow <= (overlap.rowEnd - 1) >> childShift; ++childRow) {
+        for (int childCol = overlap.colBegin >> childShift; childCol <= (overlap.colEnd - 1) >> childShift; ++childCol) {
+            int found = FindUnit(level - 1, childRow, childCol, region);
+            if (found >= 0) {
+                return found;
+            }
+        }
+    }
+    return -1;
+}
+
+int BoardSummary::FindHidden(int rowBegin, int rowEnd, int colBegin, int colEnd) const {
+    Region region;
+    if (!Clip(rowBegin, rowEnd, colBegin, colEnd, region)) {
+        return -1;
+    }
+    const Level& top = levels.back();
+    for (int unitRow = region.rowBegin >> top.shift; unitRow <= (region.rowEnd - 1) >> top.shift; ++unitRow) {
+        for (int unitCol = region.colBegin >> top.shift; unitCol <= (region.colEnd - 1) >> top.shift; ++unitCol) {
+            int found = FindUnit(BLOCK_LEVELS, unitRow, unitCol, region);
+            if (found >= 0) {
+                return found;
+            }
+        }
+    }
+    return -1;
+}
+
+bool BoardSummary::AnyHidden(int rowBegin, int rowEnd, int colBegin, int colEnd) const {
+    return FindHidden(rowBegin, rowEnd, colBegin, colEnd) >= 0;
+}
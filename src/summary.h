@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class Board;
+
+// Cells of one kind inside a block
+struct SummaryCounts {
+    int hidden;
+    int flagged;
+    int mines;
+};
+
+// Hidden, flagged and mined cells as a bitmap per 8x8 tile, with counts per 64x64 block
+// and per 512x512 superblock, built from a board in one pass. Region queries add up the
+// largest units that fit inside the region and mask the tiles along its ragged edges, so
+// a query costs about its perimeter in tiles rather than its area in cells.
+class BoardSummary
+{
+public:
+    static const int TILE_SIZE = 8;
+
+    void Build(const Board& board);
+
+    // Regions are [rowBegin, rowEnd) x [colBegin, colEnd), clipped to the board
+    int CountHidden(int rowBegin, int rowEnd, int colBegin, int colEnd) const;
+    int CountFlags(int rowBegin, int rowEnd, int colBegin, int colEnd) const;
+    int CountMines(int rowBegin, int rowEnd, int colBegin, int colEnd) const;
+    bool AnyHidden(int rowBegin, int rowEnd, int colBegin, int colEnd) const;
+    // Index of a hidden cell in the region, -1 if none. Superblocks, blocks, tiles and the
+    // cells within a tile are each searched in row-major order, so the result is stable.
+    int FindHidden(int rowBegin, int rowEnd, int colBegin, int colEnd) const;
+
+private:
+    struct Level {
+        int shift;   // A block covers (1 << shift) x (1 << shift) cells
+        int width;
+        int height;
+        std::vector<SummaryCounts> counts;
+    };
+    struct Region {
+        int rowBegin;
+        int rowEnd;
+        int colBegin;
+        int colEnd;
+    };
+
+    bool Clip(int rowBegin, int rowEnd, int colBegin, int colEnd, Region& region) const;
+    // The tiles of a block are stored together, so a block's edge costs few cache lines
+    int TileSlot(int tileRow, int tileCol) const {
+        return (((tileRow >> 3) * levels[0].width + (tileCol >> 3)) << 6) + ((tileRow & 7) << 3) + (tileCol & 7);
+    }
+    // Units of the given size wholly inside the region, as half-open unit ranges
+    void FullUnits(const Region& region, int shift, int& rowBegin, int& rowEnd, int& colBegin, int& colEnd) const;
+    uint64_t TileMask(int tileRow, int tileCol, const Region& region) const;  // Region cells within the tile
+    int Count(const Region& region, int SummaryCounts::*field, const std::vector<uint64_t>& bits) const;
+    int CountUnit(int level, int unitRow, int unitCol, const Region& region,
+                  int SummaryCounts::*field, const std::vector<uint64_t>& bits) const;
+    int FindUnit(int level, int unitRow, int unitCol, const Region& region) const;
+
+    int rows;
+    int cols;
+    std::vector<uint64_t> hiddenBits;   // Per tile, bit (row % 8) * 8 + col % 8
+    std::vector<uint64_t> flaggedBits;
+    std::vector<uint64_t> mineBits;
+    std::vector<Level> levels;   // Blocks, then superblocks
+};
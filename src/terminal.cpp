@@ -0,0 +1,126 @@
+#include <algorithm>
+
+#include "terminal.h"
+
+namespace {
+    const TerminalCell BLANK_CELL = { ' ', TERM_DEFAULT, TERM_DEFAULT };
+    const uint8_t UNKNOWN_COLOR = 254;  // Whatever was last set by someone else
+
+    void AppendNumber(std::string& out, int value) {
+        char digits[12];
+        int count = 0;
+        do {
+            digits[count++] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (count > 0) {
+            out += digits[--count];
+        }
+    }
+
+    // SGR parameter for a color: 30-37 / 90-97 foreground, 40-47 / 100-107 background
+    void AppendColor(std::string& out, uint8_t color, bool background) {
+        if (color == TERM_DEFAULT) {
+            AppendNumber(out, background ? 49 : 39);
+        } else if (color & TERM_BRIGHT) {
+            AppendNumber(out, (background ? 100 : 90) + (color & 7));
+        } else {
+            AppendNumber(out, (background ? 40 : 30) + color);
+        }
+    }
+}
+
+void TerminalScreen::Resize(int width, int height) {
+    this->width = width;
+    this->height = height;
+    front.assign(width * height, BLANK_CELL);
+    back.assign(width * height, BLANK_CELL);
+    fullRedraw = true;
+}
+
+void TerminalScreen::Clear() {
+    std::fill(front.begin(), front.end(), BLANK_CELL);
+}
+
+void TerminalScreen::Put(int x, int y, char glyph, uint8_t fg, uint8_t bg) {
+    if (x < 0 || x >= width || y < 0 || y >= height) {
+        return;
+    }
+    front[y * width + x] = { glyph, fg, bg };
+}
+
+void TerminalScreen::Text(int x, int y, const std::string& text, uint8_t fg, uint8_t bg) {
+    for (size_t i = 0; i < text.size(); ++i) {
+        Put(x + (int)i, y, text[i], fg, bg);
+    }
+}
+
+void TerminalScreen::MoveTo(int x, int y) {
+    if (x == cursorX && y == cursorY) {
+        return;
+    }
+    if (y == cursorY && x > cursorX && cursorX >= 0) {
+        // Cursor forward is shorter than an absolute move
+        output += "\x1b[";
+        if (x - cursorX > 1) AppendNumber(output, x - cursorX);
+        output += 'C';
+    } else {
+        output += "\x1b[";
+        AppendNumber(output, y + 1);
+        output += ';';
+        AppendNumber(output, x + 1);
+        output += 'H';
+    }
+    cursorX = x;
+    cursorY = y;
+}
+
+void TerminalScreen::SetColors(uint8_t fg, uint8_t bg) {
+    if (fg == currentFg && bg == currentBg) {
+        return;
+    }
+    output += "\x1b[";
+    if (fg != currentFg) {
+        AppendColor(output, fg, false);
+        if (bg != currentBg) output += ';';
+    }
+    if (bg != currentBg) {
+        AppendColor(output, bg, true);
+    }
+    output += 'm';
+    currentFg = fg;
+    currentBg = bg;
+}
+
+const std::string& TerminalScreen::Flush() {
+    output.clear();
+    cursorX = -1;  // Unknown until the first move
+    cursorY = -1;
+    currentFg = UNKNOWN_COLOR;
+    currentBg = UNKNOWN_COLOR;
+    if (fullRedraw) {
+        // Reset colors and clear, then every cell that isn't blank gets drawn
+        output += "\x1b[0m\x1b[2J";
+        currentFg = TERM_DEFAULT;
+        currentBg = TERM_DEFAULT;
+        std::fill(back.begin(), back.end(), BLANK_CELL);
+        fullRedraw = false;
+    }
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int index = y * width + x;
+            if (front[index] == back[index]) {
+                continue;
+            }
+            MoveTo(x, y);
+            SetColors(front[index].fg, front[index].bg);
+            output += front[index].glyph;
+            back[index] = front[index];
+
+            // The terminal wraps or sticks after the last column, so don't trust the cursor there
+            cursorX = x + 1 < width ? x + 1 : -1;
+        }
+    }
+    return output;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Standard ANSI colors; bright variants are BRIGHT + color
+enum TerminalColor : uint8_t {
+    TERM_BLACK = 0,
+    TERM_RED = 1,
+    TERM_GREEN = 2,
+    TERM_YELLOW = 3,
+    TERM_BLUE = 4,
+    TERM_MAGENTA = 5,
+    TERM_CYAN = 6,
+    TERM_WHITE = 7,
+    TERM_BRIGHT = 8,
+    TERM_DEFAULT = 255
+};
+
+struct TerminalCell {
+    char glyph;
+    uint8_t fg;
+    uint8_t bg;
+
+    bool operator==(const TerminalCell& other) const {
+        return glyph == other.glyph && fg == other.fg && bg == other.bg;
+    }
+    bool operator!=(const TerminalCell& other) const { return !(*this == other); }
+};
+
+// Character buffer for a terminal drawn with ANSI escapes. A frame is drawn into the buffer
+// in full, and Flush() emits only the cells that differ from the last flushed frame, moving
+// the cursor and switching colors only where needed, so a click on a huge board costs a few
+// dozen bytes on the wire instead of a screenful.
+class TerminalScreen
+{
+public:
+    TerminalScreen() : width(0), height(0), fullRedraw(true) {}
+
+    void Resize(int width, int height);  // Clears the buffer and forces a full redraw
+    void Invalidate() { fullRedraw = true; }  // The terminal's contents are unknown, e.g. after a resize
+
+    int Width() const { return width; }
+    int Height() const { return height; }
+
+    void Clear();
+    void Put(int x, int y, char glyph, uint8_t fg = TERM_DEFAULT, uint8_t bg = TERM_DEFAULT);
+    void Text(int x, int y, const std::string& text, uint8_t fg = TERM_DEFAULT, uint8_t bg = TERM_DEFAULT);
+
+    // Escape sequences that bring the terminal from the last flushed frame to this one
+    const std::string& Flush();
+
+private:
+    void MoveTo(int x, int y);
+    void SetColors(uint8_t fg, uint8_t bg);
+
+    int width;
+    int height;
+    bool fullRedraw;
+    std::vector<TerminalCell> front;  // Frame being drawn
+    std::vector<TerminalCell> back;   // Frame the terminal shows
+    std::string output;
+    int cursorX;                      // Terminal state while flushing
+    int cursorY;
+    uint8_t currentFg;
+    uint8_t currentBg;
+};
@@ -0,0 +1,95 @@
+// Compares generating small boards one at a time with bit-sliced batches of 64, both for
+// mines and counts alone and for playable boards (every lane extracted).
+// Usage: batch_benchmark [boards]   (default 64000 per size)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../src/batch.h"
+#include "../src/board.h"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const int SIZES[] = { 5, 9, 13, 16, 20 };   // Grid sizes along the progression
+    const int MINE_PERCENT = 15;
+
+    double Milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    int boards = argc > 1 ? std::atoi(argv[1]) : 64000;
+    boards -= boards % BoardBatch::LANES;
+    std::printf("%d boards per size\n", boards);
+
+    for (int size : SIZES) {
+        int mines = size * size * MINE_PERCENT / 100;
+        std::vector<unsigned int> seeds(BoardBatch::LANES);
+        BoardBatch batch;
+        Board board;
+
+        // Mines and adjacency counts only: what BoardBatch::Generate does for 64 boards at
+        // once, against the same steps of Board::Generate one board at a time. Zero cells are
+        // counted so the work can't be skipped.
+        Clock::time_point start = Clock::now();
+        long long singleZeros = 0;
+        for (int seed = 0; seed < boards; ++seed) {
+            board.Reset(size, size);
+            Board::PlaceMines(size, size, mines, seed, [&](int index) {
+                board.At(index / size, index % size).hasMine = true;
+            });
+            board.CalculateAdjacentMines();
+            board.ForEachCell([&](int, int, const Cell& cell) {
+                singleZeros += !cell.hasMine && cell.adjacentMines == 0;
+            });
+        }
+        double singleMs = Milliseconds(start);
+
+        start = Clock::now();
+        long long batchZeros = 0;
+        for (int first = 0; first < boards; first += BoardBatch::LANES) {
+            for (int lane = 0; lane < BoardBatch::LANES; ++lane) {
+                seeds[lane] = first + lane;
+            }
+            batch.Generate(size, size, mines, seeds);
+            for (int index = 0; index < size * size; ++index) {
+                batchZeros += __builtin_popcountll(batch.Zeros(index));
+            }
+        }
+        double batchMs = Milliseconds(start);
+
+        // Playable boards: a full Board::Generate each, against a batch with every lane
+        // extracted, which rebuilds the same indexes
+        start = Clock::now();
+        long long singleSafe = 0;
+        for (int seed = 0; seed < boards; ++seed) {
+            board.Generate(size, size, mines, seed);
+            singleSafe += board.RemainingCells();
+        }
+        double playableMs = Milliseconds(start);
+
+        start = Clock::now();
+        long long extractedSafe = 0;
+        for (int first = 0; first < boards; first += BoardBatch::LANES) {
+            for (int lane = 0; lane < BoardBatch::LANES; ++lane) {
+                seeds[lane] = first + lane;
+            }
+            batch.Generate(size, size, mines, seeds);
+            for (int lane = 0; lane < BoardBatch::LANES; ++lane) {
+                batch.Extract(lane, board);
+                extractedSafe += board.RemainingCells();
+            }
+        }
+        double extractedMs = Milliseconds(start);
+
+        std::printf("  %2dx%-2d  counts: single %8.1f ms  batch %8.1f ms  %5.1fx (%lld / %lld zeros)\n", size, size,
+                    singleMs, batchMs, singleMs / batchMs, singleZeros, batchZeros);
+        std::printf("         boards: single %8.1f ms  batch %8.1f ms  %5.1fx (%lld / %lld safe cells)\n",
+                    playableMs, extractedMs, playableMs / extractedMs, singleSafe, extractedSafe);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Compares the row-major and tiled cell layouts on a large board, and times summary queries.
+// Usage: board_benchmark [size] [mines]   (defaults: 4096, size * size / 64)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../src/board.h"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const int VIEWPORT_ROWS = 72;   // Cells on screen when zoomed into a huge board
+    const int VIEWPORT_COLS = 128;
+    const int VIEWPORT_FRAMES = 20000;
+    const int RANDOM_CHORDS = 200000;
+    const int REGION_QUERIES = 20000;
+
+    double Milliseconds(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    void Run(CellLayout layout, int size, int mines) {
+        Board board;
+        board.SetLayout(layout);
+        std::printf("%s\n", layout == CellLayout::TILED ? "tiled (8x8, Morton)" : "row-major");
+
+        Clock::time_point start = Clock::now();
+        board.Generate(size, size, mines, 1);
+        std::printf("  generate            %9.1f ms\n", Milliseconds(start));
+
+        // A neighbourhood pass, like the adjacency and counter passes of the rules
+        start = Clock::now();
+        long long sum = 0;
+        board.ForEachCell([&](int row, int col, const Cell&) {
+            for (int dr = -1; dr <= 1; ++dr) {
+                for (int dc = -1; dc <= 1; ++dc) {
+                    if (board.IsValidCell(row + dr, col + dc)) sum += board.At(row + dr, col + dc).adjacentMines;
+                }
+            }
+        });
+        std::printf("  3x3 pass            %9.1f ms  (%lld)\n", Milliseconds(start), sum);
+
+        // Culled rendering: visit a screenful of cells at scattered scroll positions
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> rowDis(0, size - VIEWPORT_ROWS);
+        std::uniform_int_distribution<int> colDis(0, size - VIEWPORT_COLS);
+        start = Clock::now();
+        int hidden = 0;
+        for (int frame = 0; frame < VIEWPORT_FRAMES; ++frame) {
+            int row = rowDis(rng);
+            int col = colDis(rng);
+            board.ForEachCellIn(row, row + VIEWPORT_ROWS, col, col + VIEWPORT_COLS,
+                                [&](int, int, const Cell& cell) { hidden += cell.state == CellState::HIDDEN; });
+        }
+        std::printf("  viewport visits     %9.1f ms  (%d)\n", Milliseconds(start), hidden);
+
+        // Flag a zero cell so the click below can't use the opening's precomputed spans and
+        // has to flood fill through the cells
+        int clickRow = -1;
+        int clickCol = -1;
+        for (int row = size / 2; row < size && clickRow < 0; ++row) {
+            for (int col = 1; col + 1 < size; ++col) {
+                if (!board.At(row, col).hasMine && board.At(row, col).adjacentMines == 0 &&
+                    board.At(row, col + 1).adjacentMines == 0) {
+                    clickRow = row;
+                    clickCol = col;
+                    break;
+                }
+            }
+        }
+        if (clickRow >= 0) {
+            board.ToggleFlag(clickRow, clickCol + 1);
+            std::vector<int> changed;
+            start = Clock::now();
+            board.RevealCell(clickRow, clickCol, &changed);
+            std::printf("  cascade             %9.1f ms  (%zu cells)\n", Milliseconds(start), changed.size());
+        }
+
+        // Chords at random revealed numbers: scattered 3x3 reads and writes
+        std::uniform_int_distribution<int> cellDis(0, size * size - 1);
+        start = Clock::now();
+        int chords = 0;
+        for (int i = 0; i < RANDOM_CHORDS; ++i) {
+            int index = cellDis(rng);
+            chords += board.IsSatisfied(index / size, index % size);
+        }
+        std::printf("  scattered checks    %9.1f ms  (%d)\n", Milliseconds(start), chords);
+
+        // Summary queries over random regions up to the whole board, and over viewports
+        std::uniform_int_distribution<int> edgeDis(0, size);
+        start = Clock::now();
+        long long hiddenTotal = 0;
+        for (int i = 0; i < REGION_QUERIES; ++i) {
+            int rowA = edgeDis(rng);
+            int rowB = edgeDis(rng);
+            int colA = edgeDis(rng);
+            int colB = edgeDis(rng);
+            hiddenTotal += board.Summary().CountHidden(std::min(rowA, rowB), std::max(rowA, rowB),
+                                                 std::min(colA, colB), std::max(colA, colB));
+        }
+        std::printf("  region counts       %9.1f us/query  (%lld)\n", Milliseconds(start) * 1000 / REGION_QUERIES, hiddenTotal);
+        start = Clock::now();
+        int found = 0;
+        for (int i = 0; i < REGION_QUERIES; ++i) {
+            int row = rowDis(rng);
+            int col = colDis(rng);
+            found += board.Summary().AnyHidden(row, row + VIEWPORT_ROWS, col, col + VIEWPORT_COLS);
+        }
+        std::printf("  viewport any-hidden %9.1f us/query  (%d)\n", Milliseconds(start) * 1000 / REGION_QUERIES, found);
+    }
+}
+
+int main(int argc, char** argv) {
+    int size = argc > 1 ? std::atoi(argv[1]) : 4096;
+    int mines = argc > 2 ? std::atoi(argv[2]) : size * size / 64;
+    std::printf("%dx%d board, %d mines\n", size, size, mines);
+    Run(CellLayout::ROW_MAJOR, size, mines);
+    Run(CellLayout::TILED, size, mines);
+    return 0;
+}
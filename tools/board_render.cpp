@@ -0,0 +1,223 @@
+// Exports PNG images of boards on the CPU, for save slot previews, datasets and bug reports
+// on machines without a GPU. Images are rendered and encoded in parallel, one encoder per
+// worker thread.
+// Usage: board_render [options] <save or replay files...>
+//        board_render [options] --seeds ROWSxCOLS MINES FIRST COUNT
+//   --data DIR    sprites (default: data)
+//   --cell N      pixels per cell (default: 16)
+//   --out DIR     existing output directory (default: .)
+//   --every N     for replays, one frame every N moves (default: only the final position)
+// A save file gives <name>.png and a replay <name>_<frame>.png per frame; --seeds renders the
+// fully revealed boards Board::Generate gives for COUNT seeds from FIRST, as board_<seed>.png.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../src/board.h"
+#include "../src/parallel.h"
+#include "../src/png.h"
+#include "../src/render.h"
+#include "../src/replay.h"
+
+namespace {
+    const int FRAMES_PER_JOB = 16;  // Replay frames rendered by one worker in a row
+
+    struct Job {
+        enum Kind { SAVE, REPLAY, SEED } kind;
+        std::string path;
+        int firstFrame;  // REPLAY: frames [firstFrame, lastFrame), frame k is after k * every moves
+        int lastFrame;
+        unsigned int seed;
+    };
+
+    std::string Stem(const std::string& path) {
+        size_t slash = path.find_last_of("/\\");
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        size_t dot = name.find_last_of('.');
+        return dot == std::string::npos || dot == 0 ? name : name.substr(0, dot);
+    }
+
+    bool IsReplay(const std::string& path) {
+        char magic[4] = {};
+        std::ifstream(path, std::ios::binary).read(magic, sizeof(magic));
+        return magic[0] == 'M' && magic[1] == 'S' && magic[2] == 'R' && magic[3] == 'P';
+    }
+
+    // The board part of Game::SaveGame's format: grid size, then per cell a bool mine flag
+    // and the state and adjacent mine count as ints
+    bool LoadSave(const std::string& path, Board& board) {
+        std::ifstream file(path, std::ios::binary);
+        int size = 0;
+        file.read(reinterpret_cast<char*>(&size), sizeof(size));
+        if (!file || size <= 0 || size > 4096) {
+            return false;
+        }
+        board.Reset(size, size);
+        int remaining = 0;
+        for (int row = 0; row < size; ++row) {
+            for (int col = 0; col < size; ++col) {
+                bool hasMine = false;
+                int state = 0;
+                int adjacentMines = 0;
+                file.read(reinterpret_cast<char*>(&hasMine), sizeof(bool));
+                file.read(reinterpret_cast<char*>(&state), sizeof(int));
+                file.read(reinterpret_cast<char*>(&adjacentMines), sizeof(int));
+                Cell& cell = board.At(row, col);
+                cell.hasMine = hasMine;
+                cell.state = (CellState)state;
+                cell.adjacentMines = (uint8_t)adjacentMines;
+                remaining += !hasMine && cell.state != CellState::REVEALED;
+            }
+        }
+        board.RebuildIndexes();
+        board.SetRemainingCells(remaining);
+        return (bool)file;
+    }
+
+    void Apply(Board& board, const ReplayMove& move) {
+        if (!board.IsValidCell(move.row, move.col)) return;
+        if (move.type == MoveType::REVEAL) board.RevealCell(move.row, move.col);
+        else if (move.type == MoveType::FLAG) board.ToggleFlag(move.row, move.col);
+        else board.RevealAdjacentCells(move.row, move.col);
+    }
+
+    int CountMoves(const std::string& path) {
+        ReplayReader reader;
+        if (!reader.Open(path)) {
+            return -1;
+        }
+        int moves = 0;
+        ReplayMove move;
+        while (reader.Next(move)) moves++;
+        return moves;
+    }
+
+    int Usage() {
+        std::fprintf(stderr, "usage: board_render [--data DIR] [--cell N] [--out DIR] [--every N] <save or replay files...>\n"
+                             "       board_render [options] --seeds ROWSxCOLS MINES FIRST COUNT\n");
+        return 1;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string dataDir = "data";
+    std::string outDir = ".";
+    int cellSize = 16;
+    int every = 0;
+    int seedRows = 0;
+    int seedCols = 0;
+    int seedMines = 0;
+    std::vector<Job> jobs;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            dataDir = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outDir = argv[++i];
+        } else if (arg == "--cell" && i + 1 < argc) {
+            cellSize = std::atoi(argv[++i]);
+        } else if (arg == "--every" && i + 1 < argc) {
+            every = std::atoi(argv[++i]);
+        } else if (arg == "--seeds" && i + 4 < argc) {
+            if (std::sscanf(argv[i + 1], "%dx%d", &seedRows, &seedCols) != 2 || seedRows <= 0 || seedCols <= 0) {
+                return Usage();
+            }
+            seedMines = std::atoi(argv[i + 2]);
+            unsigned int first = (unsigned int)std::strtoul(argv[i + 3], nullptr, 10);
+            int count = std::atoi(argv[i + 4]);
+            for (int n = 0; n < count; ++n) {
+                jobs.push_back({ Job::SEED, "", 0, 0, first + n });
+            }
+            i += 4;
+        } else if (!arg.empty() && arg[0] == '-') {
+            return Usage();
+        } else if (IsReplay(arg)) {
+            // Frames are split into jobs, each replaying the game from the start up to its frames
+            int moves = CountMoves(arg);
+            if (moves < 0) {
+                std::fprintf(stderr, "Skipping unreadable replay %s\n", arg.c_str());
+                continue;
+            }
+            int frames = every > 0 ? moves / every + 1 + (moves % every != 0) : 1;
+            for (int first = 0; first < frames; first += FRAMES_PER_JOB) {
+                jobs.push_back({ Job::REPLAY, arg, first, std::min(frames, first + FRAMES_PER_JOB), 0 });
+            }
+        } else {
+            jobs.push_back({ Job::SAVE, arg, 0, 0, 0 });
+        }
+    }
+    if (jobs.empty() || cellSize <= 0) {
+        return Usage();
+    }
+
+    BoardRenderer renderer;
+    if (!renderer.LoadSprites(dataDir)) {
+        std::fprintf(stderr, "Couldn't load the sprites from %s\n", dataDir.c_str());
+        return 1;
+    }
+    renderer.Prepare(cellSize);
+
+    // Every worker has its own board, image and encoder; the renderer's tiles are shared
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    int workerCount = WorkerCount();
+    std::atomic<int> next(0);
+    std::atomic<int> written(0);
+    std::atomic<int> failed(0);
+    ParallelFor(workerCount, [&](int) {
+        Board board;
+        RgbaImage image;
+        PngEncoder encoder;
+        auto save = [&](const std::string& name) {
+            renderer.Render(board, image);
+            if (encoder.Save(image, outDir + "/" + name)) written++;
+            else failed++;
+        };
+
+        for (int index = next++; index < (int)jobs.size(); index = next++) {
+            const Job& job = jobs[index];
+            if (job.kind == Job::SEED) {
+                board.Generate(seedRows, seedCols, seedMines, job.seed);
+                board.ForEachCell([](int, int, Cell& cell) { cell.state = CellState::REVEALED; });
+                board.RebuildIndexes();
+                save("board_" + std::to_string(job.seed) + ".png");
+            } else if (job.kind == Job::SAVE) {
+                if (LoadSave(job.path, board)) save(Stem(job.path) + ".png");
+                else failed++;
+            } else {
+                ReplayReader reader;
+                if (!reader.Open(job.path)) {
+                    failed++;
+                    continue;
+                }
+                const ReplayHeader& header = reader.Header();
+                board.Generate(header.rows, header.cols, header.mineCount, header.seed);
+                ReplayMove move;
+                int played = 0;
+                bool more = true;
+                for (int frame = 0; frame < job.lastFrame; ++frame) {
+                    // Frame k shows the board after k * every moves; the last one the end of the game
+                    int target = every > 0 ? frame * every : -1;
+                    while (more && (target < 0 || played < target) && (more = reader.Next(move))) {
+                        Apply(board, move);
+                        played++;
+                    }
+                    if (frame >= job.firstFrame) {
+                        char suffix[16];
+                        std::snprintf(suffix, sizeof(suffix), "_%05d.png", frame);
+                        save(Stem(job.path) + (every > 0 ? suffix : ".png"));
+                    }
+                }
+            }
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%d images (%d failed) at %d px per cell in %.2f s on %d threads, %.0f images/s\n",
+                written.load(), failed.load(), cellSize, seconds, workerCount, written / std::max(seconds, 1e-9));
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,96 @@
+/* Calls into libminesweeper the way FFI tooling does, through the C header only, and reports
+ * calls per second: single moves, batched moves and bulk view queries.
+ * Usage: capi_benchmark [games]   (default 20000 games of 16x16 with 40 mines) */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../src/minesweeper.h"
+
+#define ROWS 16
+#define COLS 16
+#define MINES 40
+
+static double Seconds(void) {
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* Reveals every safe cell in a fixed scan order, as a cheap stand-in for a solver */
+static int PlayOut(ms_board* board, const uint8_t* solution) {
+    int calls = 0;
+    for (int i = 0; i < ROWS * COLS && ms_board_status(board) == MS_STATUS_PLAYING; ++i) {
+        if (solution[i] != MS_CELL_MINE) {
+            ms_board_reveal(board, i / COLS, i % COLS);
+            calls++;
+        }
+    }
+    return calls;
+}
+
+int main(int argc, char** argv) {
+    int games = argc > 1 ? atoi(argv[1]) : 20000;
+    static uint8_t solution[ROWS * COLS];
+    static uint8_t view[ROWS * COLS];
+    static ms_move moves[ROWS * COLS];
+    ms_board* board = ms_board_create(ROWS, COLS, MINES, 0);
+    if (!board) {
+        fprintf(stderr, "ms_board_create failed\n");
+        return 1;
+    }
+    printf("libminesweeper API version %d, %d games of %dx%d\n", ms_api_version(), games, ROWS, COLS);
+
+    /* One call per move */
+    long long calls = 0;
+    double start = Seconds();
+    for (int game = 0; game < games; ++game) {
+        ms_board_generate(board, ROWS, COLS, MINES, (uint32_t)game);
+        ms_board_solution(board, 0, 0, ROWS, COLS, solution, COLS);
+        calls += PlayOut(board, solution) + 2;
+    }
+    double elapsed = Seconds() - start;
+    printf("single moves:  %8.2f M calls/s\n", calls / elapsed * 1e-6);
+
+    /* The same games as one ms_board_play call each */
+    long long played = 0;
+    start = Seconds();
+    for (int game = 0; game < games; ++game) {
+        ms_board_generate(board, ROWS, COLS, MINES, (uint32_t)game);
+        ms_board_solution(board, 0, 0, ROWS, COLS, solution, COLS);
+        size_t count = 0;
+        for (int i = 0; i < ROWS * COLS; ++i) {
+            if (solution[i] != MS_CELL_MINE) {
+                moves[count].type = MS_MOVE_REVEAL;
+                moves[count].row = i / COLS;
+                moves[count].col = i % COLS;
+                count++;
+            }
+        }
+        if (ms_board_play(board, moves, count, NULL) != MS_STATUS_WON) {
+            fprintf(stderr, "game %d wasn't won\n", game);
+            return 1;
+        }
+        played += count;
+    }
+    elapsed = Seconds() - start;
+    printf("batched moves: %8.2f M moves/s\n", played / elapsed * 1e-6);
+
+    /* Whole-board view queries mid-game */
+    ms_board_generate(board, ROWS, COLS, MINES, 1);
+    ms_board_reveal(board, 0, 0);
+    long long hidden = 0;
+    int queries = games * 50;
+    start = Seconds();
+    for (int i = 0; i < queries; ++i) {
+        ms_board_view(board, 0, 0, ROWS, COLS, view, COLS);
+        hidden += view[i % (ROWS * COLS)] == MS_CELL_HIDDEN;
+    }
+    elapsed = Seconds() - start;
+    printf("view queries:  %8.2f M calls/s, %.2f G cells/s (%lld)\n", queries / elapsed * 1e-6,
+           queries * (double)(ROWS * COLS) / elapsed * 1e-9, hidden);
+
+    ms_board_destroy(board);
+    return 0;
+}
@@ -0,0 +1,37 @@
+// Computes per-game and per-player statistics from a corpus of replays.
+// Usage: replay_analytics <manifest> <output dir>
+// The manifest has one "player<TAB>replay path" line per game, e.g. from
+//   for p in corpus/*; do for f in "$p"/*.msrp; do printf '%s\t%s\n' "${p##*/}" "$f"; done; done
+// The output directory must exist; see schema.txt there for the columns written.
+
+#include <chrono>
+#include <cstdio>
+
+#include "../src/analytics.h"
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: %s <manifest> <output dir>\n", argv[0]);
+        return 1;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    ReplayAnalytics analytics;
+    if (!analytics.Run(argv[1], argv[2])) {
+        std::fprintf(stderr, "Couldn't read %s or write to %s\n", argv[1], argv[2]);
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%lld games from %zu players in %.2f s (%lld skipped)\n", (long long)analytics.GameCount(),
+                analytics.Players().size(), seconds, (long long)analytics.SkippedCount());
+    for (size_t i = 0; i < analytics.Players().size(); ++i) {
+        const PlayerStats& player = analytics.Totals()[i];
+        std::printf("  %-16s %7lld games  %5.1f%% won  efficiency %.2f  %.2f 3BV/s\n",
+                    analytics.Players()[i].c_str(), (long long)player.games,
+                    player.games ? 100.0 * player.wins / player.games : 0.0,
+                    player.wonClicks ? (double)player.wonBbbv / player.wonClicks : 0.0,
+                    player.wonTimeMs ? player.wonBbbv * 1000.0 / player.wonTimeMs : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,558 @@
+// Minesweeper in a terminal: ANSI escapes, mouse reporting, no raylib or GPU, for playing over
+// SSH on headless machines and for watching bots. Same rules as the raylib game: boards grow
+// from 5x5 to 20x20 with every win, 15% of the cells are mines, the corners are safe, a left
+// click reveals a hidden cell or chords a number, a right click flags.
+// Only the cells that changed since the last frame are sent, so large boards stay smooth
+// over slow links.
+//
+// Usage: terminal_game [--board ROWSxCOLS] [--mines N] [--bot [MS]] [--replay FILE]
+//   --board    play one fixed size instead of the progression (e.g. 60x200)
+//   --bot      let the solver play, one move every MS milliseconds (default 100)
+//   --replay   watch a recorded game at its recorded speed
+// Keys: arrows/hjkl move, space reveals or chords, f flags, n new board, q quits.
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/board.h"
+#include "../src/deduction.h"
+#include "../src/guess.h"
+#include "../src/replay.h"
+#include "../src/terminal.h"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const int INITIAL_GRID_SIZE = 5;   // The desktop progression
+    const int MAX_GRID_SIZE = 20;
+    const int GRID_TOP = 1;            // Status line above the grid, key help below it
+    const int FRAME_MS = 250;          // Redraw interval while idle, for the clock
+    const int DEFAULT_BOT_DELAY_MS = 100;
+    const int BOT_RESTART_MS = 1500;   // Pause on a finished board before the bot starts another
+    const double GUESS_BUDGET = 0.02;
+
+    volatile sig_atomic_t quitSignal = 0;
+    volatile sig_atomic_t resizeSignal = 0;
+
+    void OnQuitSignal(int) { quitSignal = 1; }
+    void OnResizeSignal(int) { resizeSignal = 1; }
+
+    void WriteAll(const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            ssize_t count = write(STDOUT_FILENO, data.data() + written, data.size() - written);
+            if (count <= 0) {
+                return;
+            }
+            written += count;
+        }
+    }
+
+    // Raw input, the alternate screen, a hidden cursor and SGR mouse reporting while alive
+    class RawTerminal
+    {
+    public:
+        RawTerminal() : active(tcgetattr(STDIN_FILENO, &saved) == 0) {
+            if (!active) {
+                return;
+            }
+            termios raw = saved;
+            raw.c_iflag &= ~(IXON | ICRNL | BRKINT | INPCK | ISTRIP);
+            raw.c_oflag &= ~OPOST;
+            raw.c_lflag &= ~(ECHO | ICANON | IEXTEN | ISIG);
+            raw.c_cflag |= CS8;
+            raw.c_cc[VMIN] = 0;
+            raw.c_cc[VTIME] = 0;
+            tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw);
+            WriteAll("\x1b[?1049h\x1b[?25l\x1b[?1000h\x1b[?1006h");
+        }
+
+        ~RawTerminal() {
+            if (active) {
+                WriteAll("\x1b[?1000l\x1b[?1006l\x1b[0m\x1b[?25h\x1b[?1049l");
+                tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved);
+            }
+        }
+
+        bool IsActive() const { return active; }
+
+        static void Size(int& width, int& height) {
+            winsize size;
+            if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_col > 0 && size.ws_row > 0) {
+                width = size.ws_col;
+                height = size.ws_row;
+            } else {
+                width = 80;
+                height = 24;
+            }
+        }
+
+    private:
+        termios saved;
+        bool active;
+    };
+
+    struct InputEvent {
+        enum Kind { NONE, KEY, LEFT_CLICK, RIGHT_CLICK, MIDDLE_CLICK } kind;
+        int key;   // For KEY: a character, or one of the arrow codes below
+        int x;     // For clicks: 0-based screen position
+        int y;
+    };
+
+    const int KEY_UP = 1000;
+    const int KEY_DOWN = 1001;
+    const int KEY_RIGHT = 1002;
+    const int KEY_LEFT = 1003;
+
+    // Takes one event off the front of the input; returns false if it's incomplete
+    bool ParseEvent(std::string& input, InputEvent& event) {
+        event = { InputEvent::NONE, 0, 0, 0 };
+        if (input.empty()) {
+            return false;
+        }
+        if (input[0] != '\x1b') {
+            event.kind = InputEvent::KEY;
+            event.key = (unsigned char)input[0];
+            input.erase(0, 1);
+            return true;
+        }
+        if (input.size() < 3) {
+            if (input.size() == 1 || input[1] == '[') {
+                return false;  // Wait for the rest of the sequence
+            }
+            input.erase(0, 1);
+            return true;
+        }
+        if (input[1] != '[') {
+            input.erase(0, 1);
+            return true;
+        }
+
+        // SGR mouse: ESC [ < button ; x ; y (M press | m release)
+        if (input[2] == '<') {
+            size_t end = input.find_first_of("Mm", 3);
+            if (end == std::string::npos) {
+                return input.size() < 32 ? false : (input.clear(), true);
+            }
+            int button = 0;
+            int x = 0;
+            int y = 0;
+            bool parsed = std::sscanf(input.c_str() + 3, "%d;%d;%d", &button, &x, &y) == 3;
+            bool press = input[end] == 'M';
+            input.erase(0, end + 1);
+            // Presses only; motion and wheel events have bits 32 and 64 set
+            if (parsed && press && (button & ~3) == 0) {
+                static const InputEvent::Kind BUTTONS[] = {
+                    InputEvent::LEFT_CLICK, InputEvent::MIDDLE_CLICK, InputEvent::RIGHT_CLICK, InputEvent::NONE
+                };
+                event = { BUTTONS[button & 3], 0, x - 1, y - 1 };
+            }
+            return true;
+        }
+
+        static const int ARROWS[] = { KEY_UP, KEY_DOWN, KEY_RIGHT, KEY_LEFT };
+        if (input[2] >= 'A' && input[2] <= 'D') {
+            event.kind = InputEvent::KEY;
+            event.key = ARROWS[input[2] - 'A'];
+        }
+        // Skip any other CSI sequence up to its final byte
+        size_t end = 2;
+        while (end < input.size() && (input[end] < 0x40 || input[end] > 0x7e)) {
+            end++;
+        }
+        if (end == input.size()) {
+            return false;
+        }
+        input.erase(0, end + 1);
+        return true;
+    }
+
+    class TerminalGame
+    {
+    public:
+        TerminalGame(int fixedRows, int fixedCols, int fixedMines)
+            : fixedRows(fixedRows), fixedCols(fixedCols), fixedMines(fixedMines), gridSize(INITIAL_GRID_SIZE),
+              gameOver(false), gameWon(false), started(false), cursorRow(0), cursorCol(0),
+              scrollRow(0), scrollCol(0), cellWidth(2), viewRows(0), viewCols(0) {}
+
+        void NewBoard(unsigned int seed) {
+            // A win moves the progression on; a loss replays the same size
+            if (gameWon && fixedRows == 0 && gridSize < MAX_GRID_SIZE) {
+                gridSize++;
+            }
+            int rows = fixedRows > 0 ? fixedRows : gridSize;
+            int cols = fixedCols > 0 ? fixedCols : gridSize;
+            StartBoard(rows, cols, fixedMines > 0 ? fixedMines : Board::DefaultMineCount(rows, cols), seed);
+        }
+
+        void StartBoard(int rows, int cols, int mines, unsigned int seed) {
+            board.Generate(rows, cols, mines, seed);
+            mineCount = rows * cols - board.RemainingCells();  // Generate clamps the count it was asked for
+            gameOver = false;
+            gameWon = false;
+            started = false;
+            cursorRow = std::min(cursorRow, rows - 1);
+            cursorCol = std::min(cursorCol, cols - 1);
+        }
+
+        Board& GetBoard() { return board; }
+        int MineCount() const { return mineCount; }
+        bool IsOver() const { return gameOver; }
+
+        // Same controls as the desktop game, except that a plain click on a number chords,
+        // as a tap does on mobile, since terminals don't report two buttons held at once
+        void Click(int row, int col, bool flag) {
+            if (gameOver || !board.IsValidCell(row, col)) {
+                return;
+            }
+            cursorRow = row;
+            cursorCol = col;
+            const Cell& cell = board.At(row, col);
+            if (flag) {
+                if (cell.state != CellState::REVEALED) {
+                    board.ToggleFlag(row, col);
+                }
+                return;
+            }
+            if (cell.state == CellState::HIDDEN) {
+                Finish(board.RevealCell(row, col), true);
+            } else if (cell.state == CellState::REVEALED && cell.adjacentMines > 0) {
+                Finish(board.RevealAdjacentCells(row, col), false);
+            }
+        }
+
+        // Applies a move played elsewhere (a replay or the assist) without the click rules
+        void Apply(MoveType type, int row, int col) {
+            if (gameOver || !board.IsValidCell(row, col)) {
+                return;
+            }
+            cursorRow = row;
+            cursorCol = col;
+            if (type == MoveType::FLAG) board.ToggleFlag(row, col);
+            else if (type == MoveType::REVEAL) Finish(board.RevealCell(row, col), true);
+            else Finish(board.RevealAdjacentCells(row, col), false);
+        }
+
+        // Screen cell to board cell; false outside the grid
+        bool CellAt(int x, int y, int& row, int& col) const {
+            if (y < GRID_TOP || y >= GRID_TOP + viewRows || x < 0 || x >= viewCols * cellWidth) {
+                return false;
+            }
+            row = scrollRow + y - GRID_TOP;
+            col = scrollCol + x / cellWidth;
+            return board.IsValidCell(row, col);
+        }
+
+        void MoveCursor(int rowDelta, int colDelta) {
+            cursorRow = std::max(0, std::min(board.Rows() - 1, cursorRow + rowDelta));
+            cursorCol = std::max(0, std::min(board.Cols() - 1, cursorCol + colDelta));
+        }
+
+        int CursorRow() const { return cursorRow; }
+        int CursorCol() const { return cursorCol; }
+
+        void Draw(TerminalScreen& screen, const std::string& mode) {
+            screen.Clear();
+
+            // Two columns per cell when they fit, which keeps cells roughly square
+            cellWidth = board.Cols() * 2 <= screen.Width() ? 2 : 1;
+            viewCols = std::min(board.Cols(), screen.Width() / cellWidth);
+            viewRows = std::min(board.Rows(), std::max(0, screen.Height() - GRID_TOP - 1));
+
+            // Scroll just enough to keep the cursor in view
+            scrollRow = std::max(std::min(scrollRow, cursorRow), cursorRow - viewRows + 1);
+            scrollCol = std::max(std::min(scrollCol, cursorCol), cursorCol - viewCols + 1);
+            scrollRow = std::max(0, std::min(scrollRow, board.Rows() - viewRows));
+            scrollCol = std::max(0, std::min(scrollCol, board.Cols() - viewCols));
+
+            for (int y = 0; y < viewRows; ++y) {
+                for (int x = 0; x < viewCols; ++x) {
+                    int row = scrollRow + y;
+                    int col = scrollCol + x;
+                    char glyph;
+                    uint8_t fg;
+                    uint8_t bg = TERM_DEFAULT;
+                    CellGlyph(board.At(row, col), glyph, fg);
+                    if (row == cursorRow && col == cursorCol) {
+                        bg = TERM_WHITE;
+                        if (fg == TERM_DEFAULT || fg == TERM_WHITE) fg = TERM_BLACK;
+                    }
+                    screen.Put(x * cellWidth, GRID_TOP + y, glyph, fg, bg);
+                    if (cellWidth == 2) {
+                        screen.Put(x * cellWidth + 1, GRID_TOP + y, ' ', fg, bg);
+                    }
+                }
+            }
+
+            // Status line: size, mines left, time and the result once the board is done
+            char status[160];
+            int seconds = started ? (int)std::chrono::duration_cast<std::chrono::seconds>(
+                (gameOver ? endTime : Clock::now()) - startTime).count() : 0;
+            std::snprintf(status, sizeof(status), " Minesweeper %dx%d  Mines %d  Time %d  %s",
+                          board.Rows(), board.Cols(), mineCount - board.FlagCount(), seconds, mode.c_str());
+            screen.Text(0, 0, status, TERM_BLACK, TERM_WHITE);
+            screen.Text((int)std::strlen(status), 0, std::string(std::max(0, screen.Width() - (int)std::strlen(status)), ' '),
+                        TERM_BLACK, TERM_WHITE);
+            if (gameOver) {
+                const char* result = gameWon ? "  You won! Click or press n for the next board "
+                                             : "  Boom! Click or press n to try again ";
+                screen.Text(screen.Width() - (int)std::strlen(result), 0, result,
+                            TERM_WHITE | TERM_BRIGHT, gameWon ? TERM_GREEN : TERM_RED);
+            }
+            screen.Text(0, GRID_TOP + viewRows,
+                        " arrows/hjkl move  space reveal/chord  f flag  n new  q quit  (mouse: left reveal, right flag)",
+                        TERM_BLACK | TERM_BRIGHT);
+        }
+
+    private:
+        void Finish(RevealOutcome outcome, bool revealAllMines) {
+            if (outcome == RevealOutcome::NONE) {
+                return;
+            }
+            if (!started) {
+                started = true;
+                startTime = Clock::now();
+            }
+            if (outcome == RevealOutcome::HIT_MINE) {
+                gameOver = true;
+                gameWon = false;
+                endTime = Clock::now();
+                // A chord only shows the neighbouring mines, as in the game
+                if (revealAllMines) {
+                    board.RevealAllMines();
+                }
+            } else if (board.RemainingCells() == 0) {
+                gameOver = true;
+                gameWon = true;
+                endTime = Clock::now();
+            }
+        }
+
+        static void CellGlyph(const Cell& cell, char& glyph, uint8_t& fg) {
+            // Classic number colors
+            static const uint8_t NUMBER_COLORS[] = {
+                TERM_BLUE | TERM_BRIGHT, TERM_GREEN, TERM_RED | TERM_BRIGHT, TERM_BLUE,
+                TERM_RED, TERM_CYAN, TERM_MAGENTA, TERM_BLACK | TERM_BRIGHT
+            };
+            if (cell.state == CellState::FLAGGED) {
+                glyph = 'F';
+                fg = TERM_RED | TERM_BRIGHT;
+            } else if (cell.state == CellState::HIDDEN) {
+                glyph = '.';
+                fg = TERM_BLACK | TERM_BRIGHT;
+            } else if (cell.hasMine) {
+                glyph = '*';
+                fg = TERM_RED | TERM_BRIGHT;
+            } else if (cell.adjacentMines > 0) {
+                glyph = (char)('0' + cell.adjacentMines);
+                fg = NUMBER_COLORS[cell.adjacentMines - 1];
+            } else {
+                glyph = ' ';
+                fg = TERM_DEFAULT;
+            }
+        }
+
+        Board board;
+        int fixedRows;      // 0 to follow the progression
+        int fixedCols;
+        int fixedMines;     // 0 for the game's density
+        int gridSize;
+        int mineCount;
+        bool gameOver;
+        bool gameWon;
+        bool started;       // The clock starts with the first move
+        Clock::time_point startTime;
+        Clock::time_point endTime;
+        int cursorRow;
+        int cursorCol;
+        int scrollRow;
+        int scrollCol;
+        int cellWidth;
+        int viewRows;
+        int viewCols;
+    };
+
+    // The bot: reveal what the numbers prove safe, flag what they prove mined, and take the
+    // guess engine's best guess when nothing is certain. One move per call, so it can be watched.
+    class Bot
+    {
+    public:
+        void Move(TerminalGame& game) {
+            Board& board = game.GetBoard();
+            if (!deduction.Analyze(board, game.MineCount(), deductions)) {
+                deductions.safe.clear();
+                deductions.mines.clear();
+            }
+            for (int index : deductions.mines) {
+                if (board.At(index / board.Cols(), index % board.Cols()).state == CellState::HIDDEN) {
+                    game.Click(index / board.Cols(), index % board.Cols(), true);
+                    return;
+                }
+            }
+            if (!deductions.safe.empty()) {
+                game.Click(deductions.safe[0] / board.Cols(), deductions.safe[0] % board.Cols(), false);
+                return;
+            }
+            GuessChoice guess = guessEngine.Choose(board, game.MineCount(), GUESS_BUDGET);
+            if (guess.cell >= 0) {
+                game.Click(guess.cell / board.Cols(), guess.cell % board.Cols(), false);
+            }
+        }
+
+    private:
+        DeductionSolver deduction;
+        Deductions deductions;
+        GuessEngine guessEngine;
+    };
+
+    int Usage() {
+        std::fprintf(stderr, "usage: terminal_game [--board ROWSxCOLS] [--mines N] [--bot [MS]] [--replay FILE]\n");
+        return 1;
+    }
+}
+
+int main(int argc, char** argv) {
+    int rows = 0;
+    int cols = 0;
+    int mines = 0;
+    int botDelayMs = 0;
+    std::string replayFile;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--board" && i + 1 < argc) {
+            if (std::sscanf(argv[++i], "%dx%d", &rows, &cols) != 2 || rows <= 0 || cols <= 0) {
+                return Usage();
+            }
+        } else if (arg == "--mines" && i + 1 < argc) {
+            mines = std::atoi(argv[++i]);
+        } else if (arg == "--bot") {
+            botDelayMs = i + 1 < argc && argv[i + 1][0] != '-' ? std::max(1, std::atoi(argv[++i])) : DEFAULT_BOT_DELAY_MS;
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayFile = argv[++i];
+        } else {
+            return Usage();
+        }
+    }
+
+    ReplayReader replay;
+    if (!replayFile.empty() && !replay.Open(replayFile)) {
+        std::fprintf(stderr, "Can't read replay %s\n", replayFile.c_str());
+        return 1;
+    }
+
+    RawTerminal terminal;
+    if (!terminal.IsActive()) {
+        std::fprintf(stderr, "terminal_game needs a terminal\n");
+        return 1;
+    }
+    signal(SIGINT, OnQuitSignal);
+    signal(SIGTERM, OnQuitSignal);
+    signal(SIGHUP, OnQuitSignal);
+    signal(SIGWINCH, OnResizeSignal);
+
+    std::random_device rd;
+    TerminalGame game(rows, cols, mines);
+    if (replay.IsOpen()) {
+        const ReplayHeader& header = replay.Header();
+        game.StartBoard(header.rows, header.cols, header.mineCount, header.seed);
+    } else {
+        game.NewBoard(rd());
+    }
+
+    Bot bot;
+    std::string mode = replay.IsOpen() ? "[replay]" : botDelayMs > 0 ? "[bot]" : "";
+    TerminalScreen screen;
+    int width;
+    int height;
+    RawTerminal::Size(width, height);
+    screen.Resize(width, height);
+    Clock::time_point replayStart = Clock::now();
+    Clock::time_point nextBotMove = Clock::now();
+    std::string input;
+    bool running = true;
+
+    while (running && !quitSignal) {
+        if (resizeSignal) {
+            resizeSignal = 0;
+            RawTerminal::Size(width, height);
+            screen.Resize(width, height);
+        }
+        game.Draw(screen, mode);
+        WriteAll(screen.Flush());
+
+        // Sleep until input arrives, the bot's next move is due or the clock needs redrawing
+        int timeoutMs = FRAME_MS;
+        if (botDelayMs > 0) {
+            int untilMove = (int)std::chrono::duration_cast<std::chrono::milliseconds>(nextBotMove - Clock::now()).count();
+            timeoutMs = std::max(0, std::min(timeoutMs, untilMove));
+        } else if (replay.IsOpen() && !replay.Finished()) {
+            timeoutMs = std::min(timeoutMs, 20);
+        }
+        pollfd fd = { STDIN_FILENO, POLLIN, 0 };
+        if (poll(&fd, 1, timeoutMs) > 0) {
+            char buffer[256];
+            ssize_t count = read(STDIN_FILENO, buffer, sizeof(buffer));
+            if (count > 0) {
+                input.append(buffer, count);
+            } else if (count == 0) {
+                break;  // The connection went away
+            }
+        }
+
+        InputEvent event;
+        while (ParseEvent(input, event)) {
+            int row;
+            int col;
+            bool inGrid = (event.kind == InputEvent::LEFT_CLICK || event.kind == InputEvent::RIGHT_CLICK ||
+                           event.kind == InputEvent::MIDDLE_CLICK) && game.CellAt(event.x, event.y, row, col);
+            bool spectating = botDelayMs > 0 || replay.IsOpen();
+            if (event.kind == InputEvent::KEY) {
+                switch (event.key) {
+                    case 'q': case 3: running = false; break;
+                    case 'n': if (!replay.IsOpen()) game.NewBoard(rd()); break;
+                    case KEY_UP: case 'k': game.MoveCursor(-1, 0); break;
+                    case KEY_DOWN: case 'j': game.MoveCursor(1, 0); break;
+                    case KEY_LEFT: case 'h': game.MoveCursor(0, -1); break;
+                    case KEY_RIGHT: case 'l': game.MoveCursor(0, 1); break;
+                    case ' ': case '\r': if (!spectating) game.Click(game.CursorRow(), game.CursorCol(), false); break;
+                    case 'f': if (!spectating) game.Click(game.CursorRow(), game.CursorCol(), true); break;
+                }
+            } else if (inGrid && game.IsOver()) {
+                // As in the game, any click on a finished board starts the next one
+                if (!replay.IsOpen()) game.NewBoard(rd());
+            } else if (inGrid && !spectating) {
+                game.Click(row, col, event.kind == InputEvent::RIGHT_CLICK);
+            }
+        }
+
+        if (botDelayMs > 0 && Clock::now() >= nextBotMove) {
+            if (game.IsOver()) {
+                game.NewBoard(rd());
+            } else {
+                bot.Move(game);
+            }
+            nextBotMove = Clock::now() + std::chrono::milliseconds(game.IsOver() ? BOT_RESTART_MS : botDelayMs);
+        }
+
+        if (replay.IsOpen()) {
+            float replayTime = std::chrono::duration<float>(Clock::now() - replayStart).count();
+            ReplayMove move;
+            while (replay.NextDueMove(replayTime, move)) {
+                game.Apply(move.type, move.row, move.col);
+            }
+        }
+    }
+    return 0;
+}
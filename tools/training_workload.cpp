@@ -0,0 +1,203 @@
+// Headless, scripted gameplay that trains the profile-guided build (see MINESWEEPER_PGO in
+// CMakeLists.txt). It plays the progression the way the game drives the engine: speculative
+// reveals, assisted flags and chords, guesses, replay saving and playback, the difficulty
+// generator, large-board cascades with summary queries, and batch generation.
+// Usage: training_workload [replay file]   (default: training_workload.msrp, removed afterwards)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../src/assist.h"
+#include "../src/batch.h"
+#include "../src/board.h"
+#include "../src/generator.h"
+#include "../src/guess.h"
+#include "../src/replay.h"
+#include "../src/speculation.h"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const int FIRST_GRID_SIZE = 5;    // The desktop progression
+    const int LAST_GRID_SIZE = 20;
+    const int GAMES_PER_SIZE = 12;
+    const int SPECULATION_CHUNK = 256;
+    const double GUESS_BUDGET = 0.002;
+    const double GENERATION_BUDGET = 0.05;
+    const int LARGE_BOARD_SIZES[] = { 512, 2048 };
+    const int VIEWPORT_ROWS = 72;
+    const int VIEWPORT_COLS = 128;
+    const int VIEWPORT_FRAMES = 2000;
+    const int BATCHES = 200;
+
+    double Seconds(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    int MineCount(int gridSize) {
+        return std::max(1, (int)(gridSize * gridSize * 0.15f));
+    }
+
+    // A player: speculate on the cell, click it, let the assist finish the obvious moves,
+    // chord a satisfied number now and then, and guess when nothing is certain
+    class Player
+    {
+    public:
+        Player() : rng(1), gameTime(0.0f) {}
+
+        RevealOutcome Play(Board& board, int mineCount, ReplayRecorder& recorder) {
+            gameTime = 0.0f;
+            RevealOutcome outcome = Click(board, 0, 0, false, recorder);
+            int cols = board.Cols();
+            int movesLeft = board.Rows() * cols;  // Every move reveals at least one cell
+            while ((outcome == RevealOutcome::REVEALED || outcome == RevealOutcome::NONE) && movesLeft-- > 0) {
+                gameTime += 0.25f;
+
+                // Chord a random satisfied number if one is hit
+                int index = std::uniform_int_distribution<int>(0, board.Rows() * cols - 1)(rng);
+                if (board.IsSatisfied(index / cols, index % cols)) {
+                    outcome = Click(board, index / cols, index % cols, true, recorder);
+                    continue;
+                }
+
+                GuessChoice guess = guessEngine.Choose(board, mineCount, GUESS_BUDGET);
+                if (guess.cell < 0) {
+                    break;
+                }
+                outcome = Click(board, guess.cell / cols, guess.cell % cols, false, recorder);
+            }
+            return outcome;
+        }
+
+    private:
+        RevealOutcome Click(Board& board, int row, int col, bool chord, ReplayRecorder& recorder) {
+            speculation.Begin(board, row, col, chord);
+            while (!speculation.Step(board, SPECULATION_CHUNK)) {
+            }
+            changed.clear();
+            RevealOutcome outcome;
+            if (speculation.IsReadyFor(board, row, col, chord)) {
+                outcome = board.CommitPlan(speculation.Plan(), &changed);
+            } else if (chord) {
+                outcome = board.RevealAdjacentCells(row, col, &changed);
+            } else {
+                outcome = board.RevealCell(row, col, &changed);
+            }
+            speculation.Invalidate();
+            recorder.Record(chord ? MoveType::CHORD : MoveType::REVEAL, row, col, gameTime);
+            if (outcome != RevealOutcome::REVEALED) {
+                return outcome;
+            }
+            RevealOutcome assisted = assist.Run(board, changed, moves);
+            for (const AssistMove& move : moves) {
+                recorder.Record(move.type, move.row, move.col, gameTime);
+            }
+            return assisted == RevealOutcome::NONE ? outcome : assisted;
+        }
+
+        std::mt19937 rng;
+        float gameTime;
+        SpeculativeReveal speculation;
+        AutoAssist assist;
+        GuessEngine guessEngine;
+        std::vector<int> changed;
+        std::vector<AssistMove> moves;
+    };
+
+    // Plays a saved replay back onto a fresh board, as the ghost race does
+    int PlayBack(const std::string& filename, Board& board) {
+        ReplayReader reader;
+        if (!reader.Open(filename)) {
+            return 0;
+        }
+        const ReplayHeader& header = reader.Header();
+        board.Generate(header.rows, header.cols, header.mineCount, header.seed);
+        int moves = 0;
+        ReplayMove move;
+        while (reader.Next(move)) {
+            if (move.type == MoveType::REVEAL) board.RevealCell(move.row, move.col);
+            else if (move.type == MoveType::FLAG) board.ToggleFlag(move.row, move.col);
+            else board.RevealAdjacentCells(move.row, move.col);
+            moves++;
+        }
+        return moves;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string replayFile = argc > 1 ? argv[1] : "training_workload.msrp";
+    Clock::time_point start = Clock::now();
+
+    // The progression, with every game recorded, saved and played back
+    Player player;
+    Board board;
+    Board ghost;
+    ReplayRecorder recorder;
+    int wins = 0;
+    int playedBack = 0;
+    for (int gridSize = FIRST_GRID_SIZE; gridSize <= LAST_GRID_SIZE; ++gridSize) {
+        int mineCount = MineCount(gridSize);
+        for (int game = 0; game < GAMES_PER_SIZE; ++game) {
+            unsigned int seed = gridSize * 1000 + game;
+            board.Generate(gridSize, gridSize, mineCount, seed);
+            recorder.Begin({ gridSize, gridSize, mineCount, seed });
+            wins += player.Play(board, mineCount, recorder) == RevealOutcome::WON;
+            if (recorder.SaveToFile(replayFile)) {
+                playedBack += PlayBack(replayFile, ghost);
+            }
+        }
+    }
+    std::remove(replayFile.c_str());
+    std::printf("progression        %6.2f s  (%d wins, %d moves played back)\n", Seconds(start), wins, playedBack);
+
+    // Adaptive mode: difficulty-targeted generation
+    start = Clock::now();
+    BoardGenerator generator;
+    int matched = 0;
+    for (int level = 0; level < 4; ++level) {
+        DifficultyTarget target = { 0, 60, 0, level >= 3 ? 1 : 0, level >= 2 ? level : 0, std::min(level + 1, 3) };
+        for (int i = 0; i < 8; ++i) {
+            matched += generator.Generate(16, 16, MineCount(16), target, level * 100 + i, GENERATION_BUDGET).matched;
+        }
+    }
+    std::printf("generator          %6.2f s  (%d matched)\n", Seconds(start), matched);
+
+    // Huge boards: generation, a cascade from a corner and culled viewport queries
+    start = Clock::now();
+    std::mt19937 rng(7);
+    int hiddenViewports = 0;
+    for (int size : LARGE_BOARD_SIZES) {
+        board.Generate(size, size, size * size / 8, size);
+        board.RevealCell(0, 0);
+        std::uniform_int_distribution<int> rowDis(0, size - VIEWPORT_ROWS);
+        std::uniform_int_distribution<int> colDis(0, size - VIEWPORT_COLS);
+        for (int frame = 0; frame < VIEWPORT_FRAMES; ++frame) {
+            int row = rowDis(rng);
+            int col = colDis(rng);
+            hiddenViewports += board.Summary().AnyHidden(row, row + VIEWPORT_ROWS, col, col + VIEWPORT_COLS);
+            board.Summary().CountFlags(row, row + VIEWPORT_ROWS, col, col + VIEWPORT_COLS);
+        }
+    }
+    std::printf("large boards       %6.2f s  (%d viewports with hidden cells)\n", Seconds(start), hiddenViewports);
+
+    // Batch generation for simulations
+    start = Clock::now();
+    BoardBatch batch;
+    std::vector<unsigned int> seeds(BoardBatch::LANES);
+    long long zeros = 0;
+    for (int i = 0; i < BATCHES; ++i) {
+        for (int lane = 0; lane < BoardBatch::LANES; ++lane) {
+            seeds[lane] = i * BoardBatch::LANES + lane;
+        }
+        batch.Generate(9, 9, MineCount(9), seeds);
+        for (int index = 0; index < 81; ++index) {
+            zeros += __builtin_popcountll(batch.Zeros(index));
+        }
+    }
+    std::printf("batch generation   %6.2f s  (%lld zero cells)\n", Seconds(start), zeros);
+    return 0;
+}